@@ -0,0 +1,73 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "../triangle_renderer/DiredgeFile.h"
+#include "../triangle_renderer/MeshParser.h"
+
+// converts a .diredge file between the text and binary formats, the direction
+// is picked from the input: text becomes binary and binary becomes text
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    std::cout << "Usage: ./diredgeConvert <input> <output>" << std::endl;
+    return 0;
+  }
+
+  std::filesystem::path inputPath(argv[1]);
+  std::filesystem::path outputPath(argv[2]);
+
+  MappedFile inputFile(inputPath);
+  if (!inputFile.isOpen()) {
+    std::cout << "Error: failed to read file <"
+              << (std::string)inputPath.filename() << ">" << std::endl;
+    return 1;
+  }
+
+  bool binaryInput = isBinaryDiredge(inputFile.begin(), inputFile.end());
+
+  // binary input already fails to parse with this error
+  if (!binaryInput && !littleEndianHost()) {
+    std::cout << "Error: " << BINARY_HOST_ERROR << std::endl;
+    return 1;
+  }
+
+  DirectedEdgeMesh mesh;
+  std::string error;
+  bool parsed =
+      binaryInput
+          ? parseBinaryDiredge(inputFile.begin(), inputFile.end(), mesh, error)
+          : parseMeshRecords(inputFile.begin(), inputFile.end(), mesh, error);
+
+  if (!parsed || !mesh.checkIndices(error)) {
+    std::cout << "Error: " << error << std::endl;
+    return 1;
+  }
+
+  // the binary format has every array, so a text file missing any is an input
+  // error rather than a write failure
+  if ((int)mesh.otherHalves.size() != mesh.edgeCount()) {
+    std::cout << "Error: insufficient number of edge pairings specified"
+              << std::endl;
+    return 1;
+  }
+
+  if ((int)mesh.firstDirectedEdges.size() != mesh.vertexCount()) {
+    std::cout << "Error: insufficient number of vertices or FDEs specified"
+              << std::endl;
+    return 1;
+  }
+
+  bool written = binaryInput
+                     ? writeDiredgeText(outputPath, outputPath.stem(), mesh)
+                     : writeDiredgeBinary(outputPath, mesh);
+
+  if (!written) {
+    std::cout << "Error: failed to write to a file: " << outputPath.string()
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "File <" << outputPath.string() << "> written as "
+            << (binaryInput ? "text" : "binary") << std::endl;
+  return 0;
+}
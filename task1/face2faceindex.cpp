@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -5,16 +8,55 @@
 #include <vector>
 
 // libraries for data structure
-#include "../triangle_renderer/Face.h"
-#include "../triangle_renderer/Vertex.h"
+#include "../triangle_renderer/MeshParser.h"
+#include "../triangle_renderer/VertexWelder.h"
 
 int main(int argc, char *argv[]) {
-  // no arguments provided
-  if (argc != 2) {
-    std::cout << "Usage: ./face2faceindex <filepath>" << std::endl;
+  // optional weld tolerance, exact welding when it is not given
+  float tolerance = 0.0f;
+  // weld the whole soup at once with the parallel sort-based welder
+  bool parallelWeld = false;
+
+  const char *usage =
+      "Usage: ./face2faceindex [-e tolerance] [-p] <filepath | ->\n"
+      "  - reads the soup from standard input, which is held in memory whole\n"
+      "    before it is parsed, a file given by its path is mapped instead";
+
+  int arg = 1;
+  for (; arg < argc - 1; arg++) {
+    std::string option(argv[arg]);
+
+    if (option == "-e" && arg + 1 < argc - 1) {
+      // the whole argument must be a number, so a missing tolerance is not
+      // read as 0
+      char *end;
+      double value = std::strtod(argv[++arg], &end);
+      if (end == argv[arg] || *end != '\0' || !std::isfinite((float)value) ||
+          value < 0.0) {
+        std::cout << "Error: weld tolerance must be a non-negative number"
+                  << std::endl;
+        std::cout << usage << std::endl;
+        return 1;
+      }
+      tolerance = value;
+    } else if (option == "-p") {
+      parallelWeld = true;
+    } else {
+      break;
+    }
+  }
+
+  if (arg != argc - 1) {
+    std::cout << usage << std::endl;
     return 0;
   }
 
+  if (parallelWeld && tolerance > 0.0f) {
+    std::cout << "Error: the parallel welder only supports exact welding"
+              << std::endl;
+    return 1;
+  }
+
   // PHASE 1: Reading the file and storing the data, we'll want these as their
   // own structs / classes most likely Error checks: not a .tri file
 
@@ -24,93 +66,100 @@ int main(int argc, char *argv[]) {
   int vertices = 0;
   int faces = 0;
 
-  std::filesystem::path filePath(argv[1]);
-  std::ifstream inputFile(filePath, std::ios::in);
+  // the soup is read in a single pass with no seeking, so it can also come
+  // from a pipe: "-" reads standard input, which is buffered in full before
+  // it is parsed, so its peak memory holds the whole soup
+  std::filesystem::path filePath(argv[arg]);
+  bool readStdin = filePath == "-";
+  MappedFile inputFile(filePath);
+  TextScanner input(inputFile.begin(), inputFile.end());
 
-  std::vector<Vertex> vertexOutput;
-  std::vector<Face> faceOutput;
+  VertexWelder welder;
+  // three vertex ids per face
+  std::vector<int> faceVertices;
 
-  if (inputFile.is_open()) {
+  if (inputFile.isOpen()) {
     // taken the first line to be the number of faces, we can just read the
     // first input on the stream
-    if (!(inputFile >> faces)) {
-      std::cout << "invalid start line!" << std::endl;
+    if (!input.readInt(faces) || faces < 0) {
+      std::cout << "Error: invalid start line!" << std::endl;
+      return 1;
     }
 
-    // we can expect for each vertex to be given as 3 points
-    int currentLine = 1;
-    float v1, v2, v3;
-
-    while (!inputFile.eof()) {
-      inputFile >> v1 >> v2 >> v3;
+    // the header is not trusted to size the arrays: a triangle is nine
+    // numbers of at least two bytes each with their separators, so the file
+    // holds no more than a triangle per 18 bytes
+    size_t expectedFaces = std::min((size_t)faces, inputFile.size() / 18);
 
-      // error checking for bad stuff in the ifstream
+    // a closed mesh has about half as many vertices as triangles
+    welder = VertexWelder(expectedFaces / 2, tolerance);
+    faceVertices.reserve(3 * expectedFaces);
 
-      /*
-      if(inputFile.fail()){
-        std::cout << v1 << " " << v2 << " " << v3 << std::endl;
-        std::cerr << "Error: invalid vertex found on raw vertex: " <<
-      currentLine << std::endl; return 1;
-      }
-      */
+    // the parallel welder needs every corner first, the serial one welds the
+    // corners of each triangle once its third corner is in, so the partial
+    // last triangle of a truncated file adds no vertices with either
+    std::vector<Cartesian3> corners;
+    if (parallelWeld)
+      corners.reserve(3 * expectedFaces);
+    Cartesian3 triangle[3];
 
-      // for error checking
-      currentLine++;
+    float v1, v2, v3;
 
-      Cartesian3 currentVertex(v1, v2, v3);
+    size_t corner = 0;
+    for (; corner < 3 * (size_t)faces; corner++) {
+      if (!(input.readFloat(v1) && input.readFloat(v2) && input.readFloat(v3))) {
+        if (!input.atEnd()) {
+          std::cout << "Error: invalid vertex on line "
+                    << input.lineNumber(input.position()) << std::endl;
+          return 1;
+        }
 
-      bool vertexUnique = true;
-      for (auto v : vertexOutput) {
-        if (v.point == currentVertex)
-          vertexUnique = false;
+        // a truncated file keeps its complete triangles
+        std::cout << "Warning: file ends after " << corner / 3 << " of "
+                  << faces << " triangles" << std::endl;
+        faces = corner / 3;
+        if (parallelWeld)
+          corners.resize(3 * (size_t)faces);
+        faceVertices.resize(3 * (size_t)faces);
+        break;
       }
 
-      if (vertexUnique) {
-        Vertex vertexBuffer;
-
-        vertexBuffer.point = currentVertex;
-        vertexBuffer.id = vertices;
-        vertices++;
-
-        vertexOutput.push_back(vertexBuffer);
+      if (parallelWeld) {
+        corners.push_back(Cartesian3(v1, v2, v3));
+        continue;
       }
-    }
-
-    // reset to beginning of the ifstream
-    inputFile.clear();
-    inputFile.seekg(0);
-
-    int currentFace = 1;
 
-    // skip first line
-    inputFile >> faces;
-    faces = 0;
-
-    Face faceBuffer;
-
-    while (!inputFile.eof()) {
-      inputFile >> v1 >> v2 >> v3;
-      Cartesian3 currentVertex(v1, v2, v3);
+      triangle[corner % 3] = Cartesian3(v1, v2, v3);
+      if (corner % 3 == 2)
+        for (const Cartesian3 &point : triangle)
+          faceVertices.push_back(welder.weld(point));
+    }
 
-      for (auto v : vertexOutput) {
-        if (v.point == currentVertex) {
-          faceBuffer.vertexIDs.push_back(v.id);
-        }
-      }
+    // anything but whitespace after the last triangle means the count is wrong
+    if (corner == 3 * (size_t)faces && !input.atEnd()) {
+      std::cout << "Error: more vertices than the " << faces
+                << " triangles in the header" << std::endl;
+      return 1;
+    }
 
-      if (currentFace % 3 == 0) {
-        faceBuffer.id = faces;
-        faceOutput.push_back(faceBuffer);
+    if (parallelWeld) {
+      weldSorted(corners, welder.points, faceVertices);
+    }
 
-        faces++;
-        faceBuffer.vertexIDs.clear();
-      }
+    vertices = welder.points.size();
 
-      currentFace++;
+    // welding can give a triangle the same vertex twice, e.g. a sliver
+    // thinner than the tolerance, which is written as it is
+    int degenerateFaces = 0;
+    for (int f = 0; f < faces; f++) {
+      int a = faceVertices[3 * f], b = faceVertices[3 * f + 1],
+          c = faceVertices[3 * f + 2];
+      if (a == b || b == c || c == a)
+        degenerateFaces++;
     }
-
-    // close file stream afterwards
-    inputFile.close();
+    if (degenerateFaces > 0)
+      std::cout << "Warning: " << degenerateFaces
+                << " faces repeat a vertex after welding" << std::endl;
   } else {
     std::cout << "Error: failed to read file <"
               << (std::string)filePath.filename() << ">" << std::endl;
@@ -118,7 +167,7 @@ int main(int argc, char *argv[]) {
   }
 
   // PHASE 2: Writing to the file using the custom data parameters
-  std::string objectName = (std::string)filePath.stem();
+  std::string objectName = readStdin ? "stdin" : (std::string)filePath.stem();
   std::string outputFileName = objectName + ".face";
   std::ofstream outputFile(outputFileName, std::ios::out);
 
@@ -134,15 +183,15 @@ int main(int argc, char *argv[]) {
     outputFile << "#" << std::endl;
 
     // for loop for vertices
-    for (auto v : vertexOutput) {
-      outputFile << "Vertex " << v.id << "\t" << v.point << std::endl;
+    for (int v = 0; v < vertices; v++) {
+      outputFile << "Vertex " << v << "\t" << welder.points[v] << std::endl;
     }
 
     // for loop for faces
-    for (auto f : faceOutput) {
-      outputFile << "Face " << f.id << "\t";
+    for (int f = 0; f < faces; f++) {
+      outputFile << "Face " << f << "\t";
       for (int i = 0; i < 3; i++) {
-        outputFile << f.vertexIDs[i] << " ";
+        outputFile << faceVertices[3 * f + i] << " ";
       }
       outputFile << std::endl;
     }
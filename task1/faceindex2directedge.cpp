@@ -1,190 +1,127 @@
+#include <chrono>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
-#include <sstream>
 #include <string>
 #include <vector>
 
-#include "../triangle_renderer/DirectedEdge.h"
-#include "../triangle_renderer/Face.h"
-#include "../triangle_renderer/Vertex.h"
+#include "../triangle_renderer/DirectedEdgeMesh.h"
+#include "../triangle_renderer/DiredgeFile.h"
+#include "../triangle_renderer/EdgePairing.h"
+#include "../triangle_renderer/MeshParser.h"
+#include "../triangle_renderer/Parallel.h"
 
 int main(int argc, char *argv[]) {
-  if (argc != 2) {
-    std::cout << "Usage: ./faceindex2directedge <filepath>" << std::endl;
-    return 0;
-  }
-
-  // PHASE 1: Read the file and store the input
-
-  std::vector<Vertex> vertexInput;
-  std::vector<Face> faceInput;
-  std::vector<DirectedEdge> dirEdgeInput;
-
-  std::filesystem::path filePath(argv[1]);
-  std::ifstream inputFile(filePath, std::ios::in);
-  std::string inputType;
-
-  // marking as i as we are checking for input of vertices and faces
-  float i1, i2, i3;
-  int id;
-  int currentLine = 0;
-
-  std::string strLine;
-
-  if (inputFile.is_open()) {
-    while (std::getline(inputFile, strLine)) {
-      if (strLine[0] == '#')
-        continue;
-
-      // cast as a sstream so that we can parse the input
-      std::stringstream ss(strLine);
-      ss >> inputType >> id >> i1 >> i2 >> i3;
-
-      if (inputType.compare("Vertex") == 0) {
-        vertexInput.push_back(Vertex(id, i1, i2, i3));
-		
-		// std::cout << id << " " << i1 << " " << i2 << " " << i3 << std::endl;
-
-      } else if (inputType.compare("Face") == 0) {
-        faceInput.push_back(Face(id, (std::vector<int>){(int)i1, (int)i2, (int)i3}));
-      } else {
-        std::cout << "Error: invalid line format on line" << currentLine
-                  << std::endl;
-      }
-
-      currentLine++;
+  // write the binary .diredge format instead of text
+  bool binaryOutput = false;
+  // pair the other halves with the parallel sort instead of the hash table
+  bool sortPairing = false;
+  // time both pairing engines and check that they agree
+  bool benchmark = false;
+
+  int arg = 1;
+  for (; arg < argc - 1; arg++) {
+    std::string option(argv[arg]);
+
+    if (option == "-b") {
+      binaryOutput = true;
+    } else if (option == "-s") {
+      sortPairing = true;
+    } else if (option == "-t") {
+      benchmark = true;
+    } else {
+      break;
     }
-    inputFile.close();
-  } else {
-    std::cout << "Error: failed to read file <"
-              << (std::string)filePath.filename() << ">" << std::endl;
-    return 1;
   }
 
-  // calculate the directed edges now from the stored face vertices
-  int j = 0;
-  for (size_t i = 0; i < faceInput.size(); i++) {
-    std::vector<int> v = faceInput[i].vertexIDs;
-
-    // number is respect the current face
-    DirectedEdge e0(j + 0, v[0], i);
-    DirectedEdge e1(j + 1, v[1], i);
-    DirectedEdge e2(j + 2, v[2], i);
+  if (arg != argc - 1) {
+    std::cout << "Usage: ./faceindex2directedge [-b] [-s] [-t] <filepath>"
+              << std::endl;
+    return 0;
+  }
 
-    dirEdgeInput.push_back(e0);
-    dirEdgeInput.push_back(e1);
-    dirEdgeInput.push_back(e2);
-    j += 3;
+  if (binaryOutput && !littleEndianHost()) {
+    std::cout << "Error: " << BINARY_HOST_ERROR << std::endl;
+    return 1;
   }
 
-  // std::cout << "------------------------" << std::endl;
+  // PHASE 1: Read the file and store the input
+  std::filesystem::path filePath(argv[arg]);
+  DirectedEdgeMesh mesh;
+  std::string error;
 
-  /*
-  for (auto d : dirEdgeInput) {
-    std::cout << "DirEdge " << d.id
-              << " | from: " << dirEdgeInput[d.prev()].vertexID
-              << " | to: " << d.vertexID << std::endl;
+  if (!readMeshRecords(filePath, mesh, error)) {
+    std::cout << "Error: " << error << std::endl;
+    return 1;
   }
-  */
-
-  // std::cout << "------------------------" << std::endl;
 
-  std::vector<Vertex> fdeInput;
+  // the directed edges need no construction: edge e of face e / 3 points to
+  // mesh.faceVertices[e]
   std::cout << "calculating fdes..." << std::endl;
 
-  // first directed edge for each vertex
-  for (auto &v : vertexInput) {
-    for (auto d : dirEdgeInput) {
-      if (dirEdgeInput[d.prev()].vertexID == v.id) {
-        v.fdeID = d.id;
-        // std::cout << "FirstDirectedEdge " << v.id << " " << v.fdeID
-        //          << std::endl;
-        fdeInput.push_back(v);
-        break;
-      }
-    }
+  // first directed edge for each vertex, -1 for vertices without a face
+  mesh.firstDirectedEdges =
+      firstDirectedEdges(mesh.faceVertices, mesh.vertexCount());
+
+  int unusedVertices = 0;
+  int firstUnused = -1;
+  for (int v = 0; v < mesh.vertexCount(); v++) {
+    if (mesh.firstDirectedEdges[v] == -1 && unusedVertices++ == 0)
+      firstUnused = v;
   }
 
-  // std::cout << "------------------------" << std::endl;
+  if (unusedVertices > 0)
+    std::cout << "Warning: " << unusedVertices
+              << " vertices are not used by any face (the first is vertex "
+              << firstUnused << "), their first directed edge is written as -1"
+              << std::endl;
+
   std::cout << "calculating other halves..." << std::endl;
 
   // find the opposing / twin vertex
-  for (auto &d1 : dirEdgeInput) {
-
-    // we want to check whether d1 or d2 have been written to already
-    if (d1.twinID != -1)
-      continue;
-
-    for (auto &d2 : dirEdgeInput) {
-
-      if (dirEdgeInput[d1.prev()].vertexID == d2.vertexID &&
-          dirEdgeInput[d2.prev()].vertexID == d1.vertexID) {
-
-        if (d2.twinID != -1) {
-          // std::cout << "duplicate for: " << d1.id << std::endl;
-          // std::cout << d2.id << " already paired with: " << d2.twinID
-          //          << std::endl;
-          continue;
-        }
-
-        d1.twinID = d2.id;
-        d2.twinID = d1.id;
-
-        // std::cout << "OtherHalf " << d1.id << " " << d1.twinID << std::endl;
-        break;
-      }
+  if (benchmark) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> hashed = pairOtherHalves(mesh.faceVertices);
+    auto middle = std::chrono::steady_clock::now();
+    std::vector<int> sorted = pairOtherHalvesSorted(mesh.faceVertices);
+    auto finish = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double, std::milli> hashTime = middle - start;
+    std::chrono::duration<double, std::milli> sortTime = finish - middle;
+    std::cout << "hash pairing: " << hashTime.count() << " ms" << std::endl;
+    std::cout << "sort pairing: " << sortTime.count() << " ms ("
+              << threadCount() << " threads)" << std::endl;
+
+    if (hashed != sorted) {
+      std::cout << "Error: the pairing engines disagree" << std::endl;
+      return 1;
     }
   }
 
-  // std::cout << "------------------------" << std::endl;
+  if (sortPairing) {
+    EdgeRuns runs;
+    mesh.otherHalves = pairOtherHalvesSorted(mesh.faceVertices, &runs);
+    std::cout << "edges: " << runs.boundary << " boundary, " << runs.manifold
+              << " manifold, " << runs.nonManifold << " non-manifold"
+              << std::endl;
+  } else {
+    mesh.otherHalves = pairOtherHalves(mesh.faceVertices);
+  }
 
   // PHASE 2: take the stored data as file output
   std::string objectName = (std::string)filePath.stem();
   std::string outputFileName = objectName + ".diredge";
-  std::ofstream outputFile(outputFileName, std::ios::out);
-
-  if (outputFile.is_open()) {
-    outputFile << "# University of Leeds 2022-2023" << std::endl;
-    outputFile << "# COMP 5812 Assignment 1" << std::endl;
-    outputFile << "# Oliver Cheung " << std::endl;
-    outputFile << "# 201597566" << std::endl;
-    outputFile << "#" << std::endl;
-    outputFile << "# Object Name: " << objectName << std::endl;
-    outputFile << "# Vertices=" << vertexInput.size()
-               << " Faces=" << faceInput.size() << std::endl;
-    outputFile << "#" << std::endl;
-
-    for (auto v : vertexInput) {
-      outputFile << "Vertex " << v.id << "\t" << v.point.x << " " << v.point.y << " " << v.point.z << std::endl;
-    }
 
-    for (auto fde : fdeInput) {
-      outputFile << "FirstDirectedEdge " << fde.id << "\t" << fde.fdeID
-                 << std::endl;
-    }
-
-    for (auto f : faceInput) {
-      outputFile << "Face " << f.id << "\t";
-      for (int i = 0; i < 3; i++) {
-        outputFile << f.vertexIDs[i] << " ";
-      }
-      outputFile << std::endl;
-    }
+  bool written = binaryOutput
+                     ? writeDiredgeBinary(outputFileName, mesh)
+                     : writeDiredgeText(outputFileName, objectName, mesh);
 
-    for (auto de : dirEdgeInput) {
-      outputFile << "OtherHalf " << de.id << "\t" << de.twinID << std::endl;
-    }
-
-    outputFile.close();
-
-    std::cout << "File <" << outputFileName << "> written to successfully!"
-              << std::endl;
-  } else {
+  if (!written) {
     std::cout << "Error: failed to write to a file: " << outputFileName
               << std::endl;
     return 1;
   }
 
+  std::cout << "File <" << outputFileName << "> written to successfully!"
+            << std::endl;
   return 0;
 }
@@ -1,26 +1,83 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <queue>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
-#include "../triangle_renderer/DirectedEdge.h"
-#include "../triangle_renderer/Face.h"
-#include "../triangle_renderer/Vertex.h"
+#include "../triangle_renderer/DirectedEdgeMesh.h"
+#include "../triangle_renderer/DiredgeFile.h"
+#include "../triangle_renderer/MeshComponents.h"
+#include "../triangle_renderer/MeshDefects.h"
+#include "../triangle_renderer/MeshParser.h"
+#include "../triangle_renderer/Parallel.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct PhaseTimes {
+  double parse = 0.0;
+  // index and size checks, and the view
+  double construction = 0.0;
+  double edgeTest = 0.0;
+  double pinchTest = 0.0;
+  // the components and their genus
+  double genus = 0.0;
+  // the all-defects scan
+  double defects = 0.0;
+};
+
+// milliseconds since lap, which moves on to now
+double lapMilliseconds(Clock::time_point &lap) {
+  Clock::time_point now = Clock::now();
+  double elapsed = std::chrono::duration<double, std::milli>(now - lap).count();
+  lap = now;
+  return elapsed;
+}
 
 struct TestOutput {
   std::string meshName;
-  int pinchID = -1;
+  // every pinch vertex, in ascending order
+  std::vector<int> pinchIDs;
   int edgeID = -1;
   int twinID = -1;
   int genus = 0;
   bool manifold = false;
   bool readSuccessful = true;
+  std::vector<MeshComponent> components;
+
+  // phases that ran, a failed edge test stops before the pinch test, and bad
+  // indices stop the components and with them the genus
+  bool foundComponents = false;
+  bool ranEdgeTest = false;
+  bool ranPinchTest = false;
+
+  // every defect, when all of them were asked for
+  bool scannedDefects = false;
+  MeshDefects defects;
+
+  // size of the mesh, edges counted once per pair of other halves
+  int vertices = 0;
+  int edges = 0;
+  int faces = 0;
+
+  // wall-clock milliseconds spent in each phase
+  PhaseTimes times;
+
+  // why the file could not be tested, when readSuccessful is false
+  std::string error;
+  // diagnostics, printed once every file is done so that files tested at
+  // the same time do not interleave
+  std::string messages;
 };
 
-int oneRing(std::vector<DirectedEdge> dirEdgeInput, int startID) {
+int oneRing(MeshView mesh, int startID) {
   // to store the degree of the one ring
   int degree = 0;
 
@@ -28,15 +85,14 @@ int oneRing(std::vector<DirectedEdge> dirEdgeInput, int startID) {
   // check if each pair has a twin
   // if the twinID is -1, that implies that the edge does not have a twin
   // so, the test will fail
-  DirectedEdge currentEdge = dirEdgeInput[startID];
-
   int currentID = -1;
+  int currentEdge = startID;
 
   while (currentID != startID) {
 
-    DirectedEdge prevEdge = dirEdgeInput[currentEdge.prev()];
-    currentEdge = dirEdgeInput[prevEdge.twinID];
-    currentID = currentEdge.id;
+    int prevEdge = MeshView::prev(currentEdge);
+    currentEdge = mesh.otherHalves[prevEdge];
+    currentID = currentEdge;
 
     degree++;
   }
@@ -44,296 +100,573 @@ int oneRing(std::vector<DirectedEdge> dirEdgeInput, int startID) {
   return degree;
 }
 
-int pinchTest(std::vector<Vertex> vertexInput,
-              std::vector<DirectedEdge> dirEdgeInput) {
+// the vertices are split into one contiguous chunk per thread and every
+// vertex is checked, each chunk lists its pinch points in order and the lists
+// are joined in chunk order, so the result does not depend on the threads
+std::vector<int> pinchTest(MeshView mesh) {
+  std::vector<int> degrees = mesh.vertexDegrees();
+  std::vector<std::vector<int>> chunkPinches(parallelChunks(mesh.vertexCount()));
+
+  parallelFor(mesh.vertexCount(), [&](size_t begin, size_t end, int chunk) {
+    for (size_t v = begin; v < end; v++) {
+      // a vertex without faces (first directed edge -1) has no ring to check
+      if (mesh.firstDirectedEdges[v] == -1)
+        continue;
 
-  for (auto v : vertexInput) {
-    // count one ring
-    int ringDegree = oneRing(dirEdgeInput, v.fdeID);
+      // count one ring
+      int ringDegree = oneRing(mesh, mesh.firstDirectedEdges[v]);
 
-    // compare ring degree to vertex degree
-    // if they are not equal, test fails
-    if (ringDegree != v.degree) {
-      return v.id;
+      // compare ring degree to vertex degree
+      // if they are not equal, test fails
+      if (ringDegree != degrees[v])
+        chunkPinches[chunk].push_back(v);
     }
-  }
+  });
 
-  return -1;
+  std::vector<int> pinches;
+  for (auto &chunk : chunkPinches)
+    pinches.insert(pinches.end(), chunk.begin(), chunk.end());
+
+  return pinches;
 }
 
 // TASK 3
-int genusTest(std::vector<DirectedEdge> dirEdgeInput,
-              std::vector<Vertex> vertexInput, std::vector<Face> faceInput) {
+// the genus of each component is exact in integers, (2 - b - V + E - F) / 2
+// with b its boundary loops, and the components' genera are summed
+int genusTest(const std::vector<MeshComponent> &components) {
+  int genus = 0;
+  for (auto &component : components)
+    genus += component.genus;
 
-  std::vector<int> vertexCounts;
-  std::vector<int> faceCounts;
+  return genus;
+}
 
-  for (auto &v : vertexInput) {
-    if (!v.isVisited) {
+// with allDefects, indices are not checked on loading and the whole mesh is
+// scanned by findDefects instead of stopping at the first failed test
+TestOutput manifoldTest(std::filesystem::path filePath, bool allDefects) {
 
-      int vertexCount = 0;
-      int faceCount = 0;
+  TestOutput results;
+  results.meshName = (std::string)filePath.stem();
 
-      std::queue<Vertex> vertexQueue;
-      vertexQueue.push(v);
+  // PHASE 1: Parse the file
+  // a binary file is tested in place in its mapping, a text file is parsed
+  // into a mesh first, either way the tests below only see a view
+  Clock::time_point lap = Clock::now();
+  MappedFile file(filePath);
+  DirectedEdgeMesh parsed;
+  MeshView mesh;
+  std::string error;
+
+  auto fail = [&](const std::string &message) {
+    results.error = message;
+    results.readSuccessful = false;
+    return results;
+  };
 
-      v.isVisited = true;
-      vertexCount++;
+  if (filePath.extension().compare(".diredge") != 0)
+    return fail(".diredge file type required for manifold test");
 
-      while (!vertexQueue.empty()) {
+  if (!file.isOpen())
+    return fail("failed to read file");
 
-        // unqueue the current vertex (it has been visited)
-        Vertex startVertex = vertexQueue.front();
-        vertexQueue.pop();
+  if (isBinaryDiredge(file.begin(), file.end())) {
+    if (!viewBinaryDiredge(file.begin(), file.end(), mesh, error))
+      return fail(error);
+    results.times.parse = lapMilliseconds(lap);
 
-        // loop through vertices
-        DirectedEdge currentEdge = dirEdgeInput[startVertex.fdeID];
-        int currentID = -1;
+    if (!allDefects && !mesh.checkIndices(error))
+      return fail(error);
+  } else {
+    if (!parseMeshRecords(file.begin(), file.end(), parsed, error))
+      return fail(error);
+    results.times.parse = lapMilliseconds(lap);
 
-        while (currentID != startVertex.fdeID) {
+    if (!allDefects && !parsed.checkIndices(error))
+      return fail(error);
 
-          DirectedEdge prevEdge = dirEdgeInput[currentEdge.prev()];
-          currentEdge = dirEdgeInput[prevEdge.twinID];
-          currentID = currentEdge.id;
+    // PHASE 2: check the directed edge structure is complete
+    if ((int)parsed.otherHalves.size() != parsed.edgeCount())
+      return fail("insufficient number of edge pairings specified");
 
-          // check face
-          Face currentFace = faceInput[prevEdge.face()];
+    if ((int)parsed.firstDirectedEdges.size() != parsed.vertexCount())
+      return fail("insufficient number of vertices or FDEs specified");
 
-          if (!currentFace.isVisited) {
-            currentFace.isVisited = true;
-            faceInput[prevEdge.face()] = currentFace;
-            faceCount++;
-          }
+    mesh = MeshView(parsed);
+  }
 
-          // add the neighbour vertices
-          Vertex neighbourVertex = vertexInput[currentEdge.vertexID];
-          if (!neighbourVertex.isVisited) {
-            neighbourVertex.isVisited = true;
+  results.vertices = mesh.vertexCount();
+  results.faces = mesh.faceCount();
+  for (int e = 0; e < mesh.edgeCount(); e++)
+    results.edges += mesh.otherHalves[e] == -1 || e < mesh.otherHalves[e];
+  results.times.construction = lapMilliseconds(lap);
+
+  if (allDefects) {
+    results.defects = findDefects(mesh);
+    results.defects.dropFlags();
+    results.scannedDefects = true;
+    results.times.defects = lapMilliseconds(lap);
+
+    // the components need valid indices
+    if (results.defects.badIndices.count == 0) {
+      results.components = findComponents(mesh).components;
+      results.genus = genusTest(results.components);
+      results.times.genus = lapMilliseconds(lap);
+      results.foundComponents = true;
+    }
 
-            vertexQueue.push(neighbourVertex);
-            vertexInput[currentEdge.vertexID] = neighbourVertex;
-            vertexCount++;
-          }
-        }
-      }
+    results.manifold = results.defects.manifold();
+    return results;
+  }
 
-      vertexCounts.push_back(vertexCount);
-      faceCounts.push_back(faceCount);
+  // the components and genus are found before the tests, so that they are
+  // reported for meshes with boundaries too, the same as with allDefects
+  results.components = findComponents(mesh).components;
+  results.genus = genusTest(results.components);
+  results.times.genus = lapMilliseconds(lap);
+  results.foundComponents = true;
+
+  // PHASE 3: Perform each manifold test and return the result
+  results.ranEdgeTest = true;
+  for (int e = 0; e < mesh.edgeCount(); e++) {
+    int twin = mesh.otherHalves[e];
+
+    // EDGE TEST: twin is -1, implying that a half edge lies at the boundary
+    if (twin == -1) {
+
+      results.edgeID = e;
+      results.times.edgeTest = lapMilliseconds(lap);
+      return results;
+    } else if (e != mesh.otherHalves[twin]) {
+      results.messages = "Error: half edges point to different twins!\n"
+                         "de: " + std::to_string(e) + " | twin: " +
+                         std::to_string(twin) + "\nde: " +
+                         std::to_string(twin) + " | twin: " +
+                         std::to_string(mesh.otherHalves[twin]) + "\n";
+      results.twinID = e;
+      results.times.edgeTest = lapMilliseconds(lap);
+      return results;
     }
   }
+  results.times.edgeTest = lapMilliseconds(lap);
 
-  int genus = 0;
+  results.pinchIDs = pinchTest(mesh);
+  results.times.pinchTest = lapMilliseconds(lap);
+  results.ranPinchTest = true;
 
-  // for each mesh, calculate the genus using Euler's formula (slide 22,
-  // meshes_euler_formula.pdf)
-  for (size_t i = 0; i < vertexCounts.size(); i++) {
-    // 3f = 2e, so we can find the # of edges from the # of faces
-    genus += 1 - 0.5f * vertexCounts[i] + 0.25f * faceCounts[i];
-  }
+  // if a pinch point has been found, then the result is not manifold
+  if (!results.pinchIDs.empty())
+    return results;
 
-  return genus;
+  results.manifold = true;
+  return results;
 }
 
-TestOutput manifoldTest(std::filesystem::path filePath) {
-
-  std::vector<Vertex> vertexInput;
-  std::vector<Face> faceInput;
-  std::vector<DirectedEdge> dirEdgeInput;
-  std::vector<int> fdeInput;
-  std::vector<int> halfInput;
+// holds back new work while the estimated memory of the files in flight is
+// over a limit, a file larger than the limit still runs once nothing else is
+class MemoryBudget
+{
+ public:
+  MemoryBudget(uintmax_t limitBytes) : limit(limitBytes) {}
+
+  void acquire(uintmax_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex);
+    released.wait(lock, [&] { return inFlight == 0 || inFlight + bytes <= limit; });
+    inFlight += bytes;
+  }
 
-  std::ifstream inputFile(filePath, std::ios::in);
-  std::string inputType;
+  void release(uintmax_t bytes) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      inFlight -= bytes;
+    }
+    released.notify_all();
+  }
 
-  TestOutput results;
-  results.meshName = (std::string)filePath.stem();
+ private:
+  uintmax_t limit;
+  uintmax_t inFlight = 0;
+  std::mutex mutex;
+  std::condition_variable released;
+};
 
-  int i1, i2, i3;
-  int id;
-  int currentLine = 0;
-  std::string strLine;
+// the defect lists of a mesh, with a label for the text results and a key
+// for the structured ones
+struct NamedDefects {
+  const char *label;
+  const char *key;
+  const DefectList *list;
+};
 
-  // PHASE 1: Parse the file
-  if (inputFile.is_open()) {
-    while (std::getline(inputFile, strLine)) {
-      if (strLine[0] == '#')
-        continue;
+std::vector<NamedDefects> namedDefects(const MeshDefects &d) {
+  return {{"Out-of-range indices (edges)", "badIndices", &d.badIndices},
+          {"Bad first directed edges (vertices)", "badFirstEdges",
+           &d.badFirstEdges},
+          {"Boundary edges", "boundaryEdges", &d.boundaryEdges},
+          {"Twin mismatches (edges)", "twinMismatches", &d.twinMismatches},
+          {"Pinch vertices", "pinchVertices", &d.pinchVertices},
+          {"Degenerate faces", "degenerateFaces", &d.degenerateFaces}};
+}
 
-      std::stringstream ss(strLine);
-      ss >> inputType >> id >> i1 >> i2 >> i3;
-
-      if (inputType.compare("Vertex") == 0) {
-        vertexInput.push_back(Vertex(id, (float)i1, (float)i2, (float)i3));
-      } else if (inputType.compare("FirstDirectedEdge") == 0) {
-        fdeInput.push_back(i1);
-      } else if (inputType.compare("Face") == 0) {
-        faceInput.push_back(Face(id, (std::vector<int>){i1, i2, i3}));
-      } else if (inputType.compare("OtherHalf") == 0) {
-        halfInput.push_back(i1);
-      } else {
-        std::cout << "Error: invalid line format on line" << currentLine
-                  << std::endl;
-        results.readSuccessful = false;
-        return results;
+void writeTextResults(std::ostream &outputFile,
+                      const std::vector<TestOutput> &testResults,
+                      bool listComponents) {
+  for (auto &t : testResults) {
+    outputFile << "--------------------------" << std::endl;
+    outputFile << "File: " << t.meshName << std::endl;
+
+    if (!t.readSuccessful) {
+      outputFile << "Error: " << t.error << std::endl;
+    } else if (t.manifold) {
+      outputFile << "Manifold: YES" << std::endl;
+      outputFile << "Genus: " << t.genus << std::endl;
+    } else {
+      outputFile << "Manifold: NO" << std::endl;
+      if (!t.pinchIDs.empty()) {
+        outputFile << "<PINCH TEST FAILED> on "
+                   << (t.pinchIDs.size() == 1 ? "Vertex:" : "Vertices:");
+        for (int v : t.pinchIDs)
+          outputFile << " " << v;
+        outputFile << std::endl;
       }
+      if (t.edgeID != -1)
+        outputFile << "<BOUNDARY TEST FAILED> on Edge: " << t.edgeID
+                   << std::endl;
+      if (t.twinID != -1)
+        outputFile << "<TWIN TEST FAILED> on Edge: " << t.twinID << std::endl;
+    }
 
-      currentLine++;
+    if (t.scannedDefects) {
+      for (auto &[label, key, list] : namedDefects(t.defects)) {
+        outputFile << label << ": " << list->count;
+        if (!list->examples.empty()) {
+          outputFile << " (first:";
+          for (int id : list->examples)
+            outputFile << " " << id;
+          outputFile << (list->count > list->examples.size() ? " ...)" : ")");
+        }
+        outputFile << std::endl;
+      }
     }
 
-    inputFile.close();
-  } else {
-    std::cout << "Error: failed to read file <"
-              << (std::string)filePath.filename() << ">" << std::endl;
-    results.readSuccessful = false;
-    return results;
+    if (listComponents && t.readSuccessful) {
+      outputFile << "Components: " << t.components.size() << std::endl;
+      for (size_t c = 0; c < t.components.size(); c++) {
+        const MeshComponent &component = t.components[c];
+        outputFile << "  Component " << c << ": V=" << component.vertices
+                   << " E=" << component.edges << " F=" << component.faces
+                   << " Boundary loops=" << component.boundaryLoops
+                   << " Euler=" << component.eulerCharacteristic
+                   << " Genus=" << component.genus << std::endl;
+      }
+    }
   }
 
-  // PHASE 2: DATA CONSTRUCTION
-  // making sure things are nice and tidy to do testing
-  for (auto f : faceInput) {
-    for (auto vID : f.vertexIDs) {
-      vertexInput[vID].degree++;
+  outputFile << "--------------------------" << std::endl;
+}
+
+// a JSON string literal, control characters escaped
+std::string jsonString(const std::string &text) {
+  std::string quoted = "\"";
+  for (unsigned char c : text) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (c < 0x20) {
+      const char hex[] = "0123456789abcdef";
+      quoted += "\\u00";
+      quoted += hex[c >> 4];
+      quoted += hex[c & 15];
+    } else {
+      quoted += c;
     }
   }
+  return quoted + "\"";
+}
 
-  // construct the directed edges
-  int j = 0;
-  for (size_t i = 0; i < faceInput.size(); i++) {
-    std::vector<int> v = faceInput[i].vertexIDs;
-
-    // number is respect the current face
-    DirectedEdge e0(j + 0, v[0], i);
-    DirectedEdge e1(j + 1, v[1], i);
-    DirectedEdge e2(j + 2, v[2], i);
+// a CSV field, quoted when it holds a separator, quote or line break
+std::string csvField(const std::string &text) {
+  if (text.find_first_of(",\"\r\n") == std::string::npos)
+    return text;
 
-    dirEdgeInput.push_back(e0);
-    dirEdgeInput.push_back(e1);
-    dirEdgeInput.push_back(e2);
-    j += 3;
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"')
+      quoted += '"';
+    quoted += c;
   }
+  return quoted + "\"";
+}
 
-  if (dirEdgeInput.size() != halfInput.size()) {
-    std::cout << "Error: insufficient number of edge pairings specified"
-              << std::endl;
-    results.readSuccessful = false;
-    return results;
-  }
+// pinch vertices listed in the structured results, the count is always given
+const size_t PINCH_ID_LIMIT = 10;
 
-  if (fdeInput.size() != vertexInput.size()) {
-    std::cout << "Error: insufficient number of vertices or FDEs specified"
-              << std::endl;
-    results.readSuccessful = false;
-    return results;
-  }
+// a phase's time as text, empty for a phase that did not run
+std::string phaseTime(bool ran, double milliseconds) {
+  if (!ran)
+    return "";
+  std::ostringstream text;
+  text << milliseconds;
+  return text.str();
+}
 
-  // PHASE 3: Perform each manifold test and return the result
-  int e = 0;
-  for (auto &de : dirEdgeInput) {
-    de.twinID = halfInput[e];
-    e++;
-  }
+// one JSON object per line and mesh, a file that could not be tested only has
+// its error, and the results and timings of a phase that did not run (the
+// pinch test after a failed edge test, the edge and pinch tests when every
+// defect was scanned, the defects otherwise) are null
+void writeJsonResults(std::ostream &outputFile,
+                      const std::vector<TestOutput> &testResults) {
+  for (auto &t : testResults) {
+    outputFile << "{\"file\":" << jsonString(t.meshName)
+               << ",\"ok\":" << (t.readSuccessful ? "true" : "false")
+               << ",\"error\":"
+               << (t.readSuccessful ? "null" : jsonString(t.error));
+
+    if (!t.readSuccessful) {
+      outputFile << "}" << std::endl;
+      continue;
+    }
 
-  e = 0;
-  for (auto de : dirEdgeInput) {
-    // EDGE TEST: twin is -1, implying that a half edge lies at the boundary
-    if (de.twinID == -1) {
+    outputFile << ",\"manifold\":" << (t.manifold ? "true" : "false")
+               << ",\"genus\":"
+               << (t.foundComponents ? std::to_string(t.genus) : "null")
+               << ",\"edgeID\":" << t.edgeID << ",\"twinID\":" << t.twinID;
+
+    if (t.ranPinchTest) {
+      outputFile << ",\"pinchCount\":" << t.pinchIDs.size() << ",\"pinchIDs\":[";
+      for (size_t i = 0; i < t.pinchIDs.size() && i < PINCH_ID_LIMIT; i++)
+        outputFile << (i > 0 ? "," : "") << t.pinchIDs[i];
+      outputFile << "]";
+    } else {
+      outputFile << ",\"pinchCount\":null,\"pinchIDs\":null";
+    }
 
-      results.edgeID = e;
-      return results;
-    } else if (de.id != dirEdgeInput[de.twinID].twinID) {
-      std::cout << "Error: half edges point to different twins!" << std::endl;
-      std::cout << "de: " << de.id << " | twin: " << de.twinID << std::endl;
-      std::cout << "de: " << de.twinID
-                << " | twin: " << dirEdgeInput[de.twinID].twinID << std::endl;
-      results.twinID = e;
-      return results;
+    outputFile << ",\"vertices\":" << t.vertices << ",\"edges\":" << t.edges
+               << ",\"faces\":" << t.faces;
+
+    if (t.foundComponents) {
+      outputFile << ",\"components\":" << t.components.size()
+                 << ",\"componentGenus\":[";
+      for (size_t c = 0; c < t.components.size(); c++)
+        outputFile << (c > 0 ? "," : "") << t.components[c].genus;
+      outputFile << "]";
+    } else {
+      outputFile << ",\"components\":null,\"componentGenus\":null";
     }
 
-    e++;
-  }
+    outputFile << ",\"defects\":";
+    if (t.scannedDefects) {
+      const char *separator = "{";
+      for (auto &[label, key, list] : namedDefects(t.defects)) {
+        outputFile << separator << "\"" << key << "\":{\"count\":" << list->count
+                   << ",\"first\":[";
+        for (size_t i = 0; i < list->examples.size(); i++)
+          outputFile << (i > 0 ? "," : "") << list->examples[i];
+        outputFile << "]}";
+        separator = ",";
+      }
+      outputFile << "}";
+    } else {
+      outputFile << "null";
+    }
 
-  // assign the FDEs based on file input
-  e = 0;
-  for (auto &v : vertexInput) {
-    v.fdeID = fdeInput[e];
-    e++;
+    auto jsonTime = [](bool ran, double milliseconds) {
+      return ran ? phaseTime(ran, milliseconds) : "null";
+    };
+
+    const PhaseTimes &times = t.times;
+    outputFile << ",\"timingsMs\":{\"parse\":" << times.parse
+               << ",\"construction\":" << times.construction
+               << ",\"edgeTest\":" << jsonTime(t.ranEdgeTest, times.edgeTest)
+               << ",\"pinchTest\":"
+               << jsonTime(t.ranPinchTest, times.pinchTest)
+               << ",\"genus\":" << jsonTime(t.foundComponents, times.genus)
+               << ",\"defects\":"
+               << jsonTime(t.scannedDefects, times.defects) << "}}"
+               << std::endl;
   }
+}
 
-  results.pinchID = pinchTest(vertexInput, dirEdgeInput);
-  results.genus = genusTest(dirEdgeInput, vertexInput, faceInput);
+// a header row and one row per mesh, columns of phases that did not run are
+// empty
+void writeCsvResults(std::ostream &outputFile,
+                     const std::vector<TestOutput> &testResults) {
+  outputFile << "file,ok,error,manifold,genus,edgeID,twinID,pinchCount,"
+                "pinchIDs,vertices,edges,faces,components,componentGenus";
+  for (auto &named : namedDefects(MeshDefects()))
+    outputFile << "," << named.key;
+  outputFile << ",parseMs,constructionMs,edgeTestMs,pinchTestMs,genusMs,"
+                "defectsMs"
+             << std::endl;
+
+  for (auto &t : testResults) {
+    outputFile << csvField(t.meshName) << "," << (t.readSuccessful ? 1 : 0)
+               << "," << csvField(t.error);
+
+    if (!t.readSuccessful) {
+      // the 11 result, 6 defect and 6 timing columns after the error
+      outputFile << std::string(23, ',') << std::endl;
+      continue;
+    }
 
-  // if a pinch point has been found, then the result is not manifold
-  if (results.pinchID != -1)
-    return results;
+    // lists are separated with semicolons inside one field
+    std::string pinchIDs, componentGenus;
+    for (size_t i = 0; i < t.pinchIDs.size() && i < PINCH_ID_LIMIT; i++)
+      pinchIDs += (i > 0 ? ";" : "") + std::to_string(t.pinchIDs[i]);
+    for (size_t c = 0; c < t.components.size(); c++)
+      componentGenus +=
+          (c > 0 ? ";" : "") + std::to_string(t.components[c].genus);
+
+    outputFile << "," << (t.manifold ? 1 : 0) << ","
+               << (t.foundComponents ? std::to_string(t.genus) : "") << ","
+               << t.edgeID << "," << t.twinID << ","
+               << (t.ranPinchTest ? std::to_string(t.pinchIDs.size()) : "")
+               << "," << pinchIDs << "," << t.vertices << "," << t.edges << ","
+               << t.faces << ","
+               << (t.foundComponents ? std::to_string(t.components.size()) : "")
+               << "," << componentGenus;
+
+    for (auto &named : namedDefects(t.defects)) {
+      outputFile << ",";
+      if (t.scannedDefects)
+        outputFile << named.list->count;
+    }
 
-  results.manifold = true;
-  return results;
+    const PhaseTimes &times = t.times;
+    outputFile << "," << times.parse << "," << times.construction << ","
+               << phaseTime(t.ranEdgeTest, times.edgeTest) << ","
+               << phaseTime(t.ranPinchTest, times.pinchTest) << ","
+               << phaseTime(t.foundComponents, times.genus) << ","
+               << phaseTime(t.scannedDefects, times.defects) << std::endl;
+  }
 }
 
 int main(int argc, char *argv[]) {
+  // list the components of every mesh in the results
+  bool listComponents = false;
+  // report every defect of each mesh rather than the first failed test
+  bool allDefects = false;
+  // estimated memory of the files being tested at once, in megabytes
+  uintmax_t memoryLimit = 1024;
+  // results file format, txt, jsonl or csv
+  std::string format = "txt";
+
+  int arg = 1;
+  for (; arg < argc - 1; arg++) {
+    std::string option(argv[arg]);
+
+    if (option == "-c") {
+      listComponents = true;
+    } else if (option == "-a") {
+      allDefects = true;
+    } else if (option == "-m" && arg + 1 < argc - 1) {
+      memoryLimit = std::strtoull(argv[++arg], nullptr, 10);
+      if (memoryLimit == 0) {
+        std::cout << "Error: the memory limit must be a positive number of "
+                     "megabytes"
+                  << std::endl;
+        return 1;
+      }
+    } else if (option == "-f" && arg + 1 < argc - 1) {
+      format = argv[++arg];
+      if (format != "txt" && format != "jsonl" && format != "csv") {
+        std::cout << "Error: the results format must be txt, jsonl or csv"
+                  << std::endl;
+        return 1;
+      }
+    } else {
+      break;
+    }
+  }
 
-  if (argc != 2) {
-    std::cout << "Usage: ./manifoldTest <directory_path>" << std::endl;
+  if (arg != argc - 1) {
+    std::cout << "Usage: ./manifoldTest [-a] [-c] [-f txt|jsonl|csv] "
+                 "[-m megabytes] <directory_path>"
+              << std::endl;
     return 0;
   }
 
-  // TODO: check if the filetype is a directory, and the user hasn't just
-  // specified a file
-
-  std::vector<TestOutput> testResults;
+  std::filesystem::path directory(argv[arg]);
+  if (!std::filesystem::is_directory(directory)) {
+    std::cout << "Error: <" << directory.string() << "> is not a directory"
+              << std::endl;
+    return 1;
+  }
 
   // PHASE 1: Read the file and store the input
-  for (auto testFile : std::filesystem::directory_iterator(argv[1])) {
-
-    std::string fileName = (std::string)testFile.path().filename();
-
-    if (testFile.path().extension().compare(".diredge") != 0) {
-      std::cout << "Error: .diredge file type required for manifold test"
-                << std::endl;
-      std::cout << "File: <" << fileName << "> does not fit this criteria"
-                << std::endl;
-      return 1;
-    }
+  // the results are kept in file name order
+  std::vector<std::filesystem::path> testFiles;
+  for (auto &testFile : std::filesystem::directory_iterator(directory))
+    testFiles.push_back(testFile.path());
+  std::sort(testFiles.begin(), testFiles.end());
+
+  std::vector<uintmax_t> fileSizes(testFiles.size(), 0);
+  for (size_t f = 0; f < testFiles.size(); f++) {
+    std::error_code ignored;
+    if (std::filesystem::is_regular_file(testFiles[f], ignored))
+      fileSizes[f] = std::filesystem::file_size(testFiles[f], ignored);
+  }
 
-    // execute test on each of them and store the result
-    TestOutput result = manifoldTest(testFile.path());
-    if (!result.readSuccessful) {
-      std::cout << "Error: read failed on file: <" << fileName << ">"
-                << std::endl;
-      return 1;
+  // largest files first, so that a big file does not start last and hold up
+  // the end of the run
+  std::vector<size_t> order(testFiles.size());
+  for (size_t f = 0; f < order.size(); f++)
+    order[f] = f;
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return fileSizes[a] > fileSizes[b];
+  });
+
+  // a text file is mapped and parsed into arrays of about its own size, a
+  // binary one is only mapped, so twice the file size covers both
+  MemoryBudget budget(memoryLimit << 20);
+  std::vector<TestOutput> testResults(testFiles.size());
+  int workers = std::min<size_t>(threadCount(), testFiles.size());
+
+  // with a file for every thread, each file is tested on one thread, with
+  // fewer the files' own loops share the threads left over as well
+  bool serialFiles = workers > 1 && testFiles.size() >= (size_t)threadCount();
+
+  parallelQueue(order.size(), workers, [&](size_t item) {
+    size_t f = order[item];
+    uintmax_t estimate = 2 * fileSizes[f];
+
+    std::unique_ptr<SerialScope> serial;
+    if (serialFiles)
+      serial = std::make_unique<SerialScope>();
+
+    budget.acquire(estimate);
+    testResults[f] = manifoldTest(testFiles[f], allDefects);
+    budget.release(estimate);
+  });
+
+  int failedFiles = 0;
+  for (size_t f = 0; f < testFiles.size(); f++) {
+    std::cout << testResults[f].messages;
+    if (!testResults[f].readSuccessful) {
+      std::cout << "Error: read failed on file: <"
+                << (std::string)testFiles[f].filename()
+                << ">: " << testResults[f].error << std::endl;
+      failedFiles++;
     }
-
-    testResults.push_back(result);
   }
 
   // PHASE 2: take the stored data as file output
-  std::string outputFileName = "manifold_results.txt";
+  std::string outputFileName = "manifold_results." + format;
   std::ofstream outputFile(outputFileName, std::ios::out);
 
   if (outputFile.is_open()) {
-
-    for (auto t : testResults) {
-      outputFile << "--------------------------" << std::endl;
-      outputFile << "File: " << t.meshName << std::endl;
-
-      if (t.manifold) {
-        outputFile << "Manifold: YES" << std::endl;
-        outputFile << "Genus: " << t.genus << std::endl;
-      } else {
-        outputFile << "Manifold: NO" << std::endl;
-        if (t.pinchID != -1)
-          outputFile << "<PINCH TEST FAILED> on Vertex: " << t.pinchID
-                     << std::endl;
-        if (t.edgeID != -1)
-          outputFile << "<BOUNDARY TEST FAILED> on Edge: " << t.edgeID
-                     << std::endl;
-        if (t.twinID != -1)
-          outputFile << "<TWIN TEST FAILED> on Edge: " << t.twinID << std::endl;
-      }
-    }
-
-    outputFile << "--------------------------" << std::endl;
+    if (format == "jsonl")
+      writeJsonResults(outputFile, testResults);
+    else if (format == "csv")
+      writeCsvResults(outputFile, testResults);
+    else
+      writeTextResults(outputFile, testResults, listComponents);
+  } else {
+    std::cout << "Error: failed to write to a file: " << outputFileName
+              << std::endl;
+    return 1;
   }
 
-  return 0;
+  // the results are written either way, but a file that could not be tested
+  // fails the run
+  return failedFiles > 0 ? 1 : 0;
 }
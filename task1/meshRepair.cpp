@@ -1,313 +1,510 @@
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
-#include "../triangle_renderer/DirectedEdge.h"
-#include "../triangle_renderer/Face.h"
-#include "../triangle_renderer/Vertex.h"
+#include "../triangle_renderer/Bitset.h"
+#include "../triangle_renderer/DirectedEdgeMesh.h"
+#include "../triangle_renderer/DiredgeFile.h"
+#include "../triangle_renderer/HoleRefinement.h"
+#include "../triangle_renderer/HoleTriangulation.h"
+#include "../triangle_renderer/MeshFairing.h"
+#include "../triangle_renderer/MeshParser.h"
+#include "../triangle_renderer/Parallel.h"
 
-int oneBoundary(std::vector<DirectedEdge> dirEdgeInput, int startID) {
+int oneBoundary(const DirectedEdgeMesh &mesh, int startID) {
 
   // traverse the one ring until we reach a boundary
-  DirectedEdge currentEdge = dirEdgeInput[startID];
-  int currentID = -1;
+  // a fan has at most one edge per directed edge of the mesh, so a walk
+  // through inconsistent other halves gives up rather than going round forever
+  int currentEdge = startID;
 
-  while (currentID != startID) {
-    DirectedEdge prevEdge = dirEdgeInput[currentEdge.prev()];
+  for (int step = 0; step < mesh.edgeCount(); step++) {
+    int prevEdge = DirectedEdgeMesh::prev(currentEdge);
 
-    if (prevEdge.twinID == -1) {
+    if (mesh.otherHalves[prevEdge] == -1) {
       // store the directed edge who has the boundary of its pair
-      return prevEdge.id;
+      return prevEdge;
     }
 
-    currentEdge = dirEdgeInput[prevEdge.twinID];
-    currentID = currentEdge.id;
+    currentEdge = mesh.otherHalves[prevEdge];
+    if (currentEdge == startID)
+      break;
   }
 
-  // if there is no boundary, return 0
-  return 0;
+  // if there is no boundary, return -1
+  return -1;
 }
 
-int main(int argc, char *argv[]) {
-  if (argc != 2) {
-    std::cout << "Usage: ./meshRepair <filepath>" << std::endl;
-    return 0;
-  }
-
-  std::vector<Vertex> vertexInput;
-  std::vector<Face> faceInput;
-  std::vector<DirectedEdge> dirEdgeInput;
-  std::vector<int> fdeInput;
-  std::vector<int> halfInput;
-
-  std::filesystem::path filePath(argv[1]);
+// the boundary edges of a mesh, each found from the one after it in O(1)
+class BoundaryMap
+{
+ public:
+  BoundaryMap(const DirectedEdgeMesh &mesh)
+      : mesh(mesh), boundaryInto(mesh.vertexCount(), -1),
+        sharedVertex(mesh.vertexCount()) {
+    for (int e = 0; e < mesh.edgeCount(); e++) {
+      if (mesh.otherHalves[e] != -1)
+        continue;
 
-  if (filePath.extension().compare(".diredge") != 0) {
-    std::cout << "Error: .diredge file type required for manifold test"
-              << std::endl;
-    return 1;
+      int v = mesh.to(e);
+      if (boundaryInto[v] == -1)
+        boundaryInto[v] = e;
+      else
+        sharedVertex.set(v);
+    }
   }
 
-  std::ifstream inputFile(filePath, std::ios::in);
-  std::string inputType;
+  // vertices with more than one boundary edge ending at them
+  std::vector<int> sharedVertices() const {
+    std::vector<int> vertices;
+    for (int v = 0; v < mesh.vertexCount(); v++)
+      if (sharedVertex.test(v))
+        vertices.push_back(v);
+    return vertices;
+  }
 
-  float i1, i2, i3;
-  int id;
-  int currentLine = 0;
+  // the boundary edge ending where boundary edge e starts, -1 if there is none
+  // where several loops meet, the one in the same fan of faces as e is taken
+  int previous(int e) const {
+    int v = mesh.from(e);
+    return sharedVertex.test(v) ? oneBoundary(mesh, e) : boundaryInto[v];
+  }
 
-  std::string strLine;
+ private:
+  const DirectedEdgeMesh &mesh;
+  std::vector<int> boundaryInto;
+  Bitset sharedVertex;
+};
+
+// give every fan of faces around a vertex after its first a copy of the
+// vertex, so that each vertex has a single fan, returns the number of
+// vertices split and adds the number of copies to addedVertices
+//
+// a vertex is pinched when the fan at its first directed edge has fewer
+// edges than the vertex has faces, found in O(E), then only the edges around
+// the pinched vertices are rewired: the copy takes the edges of its fan that
+// end at the vertex, and the other halves stay as they are
+int splitPinchVertices(DirectedEdgeMesh &mesh, int &addedVertices) {
+  std::vector<int> degrees = mesh.vertexDegrees();
+  std::vector<int> fan;
+
+  Bitset pinched(mesh.vertexCount());
+  std::vector<int> pinchedVertices;
+  for (int v = 0; v < mesh.vertexCount(); v++) {
+    if (degrees[v] == 0)
+      continue;
+
+    int first = mesh.firstDirectedEdges[v];
+    fan.clear();
+    if (first != -1 && mesh.from(first) == v)
+      mesh.fanEdges(first, fan, degrees[v]);
+
+    if (first == -1 || mesh.from(first) != v || (int)fan.size() != degrees[v]) {
+      pinched.set(v);
+      pinchedVertices.push_back(v);
+    }
+  }
 
-  // PHASE 1: Parse the file
-  if (inputFile.is_open()) {
-    while (std::getline(inputFile, strLine)) {
+  // the edges out of each pinched vertex, in edge order
+  std::unordered_map<int, std::vector<int>> outEdges;
+  for (int e = 0; e < mesh.edgeCount(); e++)
+    if (pinched.test(mesh.from(e)))
+      outEdges[mesh.from(e)].push_back(e);
+
+  Bitset inFan(mesh.edgeCount());
+  int splitVertices = 0;
+
+  for (int v : pinchedVertices) {
+    const std::vector<int> &edges = outEdges[v];
+
+    // the fan at a valid first directed edge keeps the vertex, otherwise the
+    // fan of the lowest edge does
+    int first = mesh.firstDirectedEdges[v];
+    bool kept = first != -1 && mesh.from(first) == v;
+    if (kept) {
+      fan.clear();
+      mesh.fanEdges(first, fan, edges.size());
+      for (int e : fan)
+        inFan.set(e);
+    }
 
-      if (strLine[0] == '#')
+    int copies = 0;
+    for (int start : edges) {
+      if (inFan.test(start))
         continue;
 
-      std::stringstream ss(strLine);
-      ss >> inputType >> id >> i1 >> i2 >> i3;
-
-      if (inputType.compare("Vertex") == 0) {
-        vertexInput.push_back(Vertex(id, i1, i2, i3));
-      } else if (inputType.compare("FirstDirectedEdge") == 0) {
-        fdeInput.push_back(i1);
-      } else if (inputType.compare("Face") == 0) {
-        faceInput.push_back(Face(id, (std::vector<int>){(int)i1, (int)i2, (int)i3}));
-      } else if (inputType.compare("OtherHalf") == 0) {
-        halfInput.push_back(i1);
-      } else {
-        std::cout << "Error: invalid line format on line" << currentLine
-                  << std::endl;
+      fan.clear();
+      mesh.fanEdges(start, fan, edges.size());
 
-        return 1;
+      int target = v;
+      if (kept) {
+        target = mesh.addVertex(mesh.position(v));
+        copies++;
       }
+      kept = true;
+      mesh.firstDirectedEdges[target] = start;
 
-      currentLine++;
+      for (int e : fan) {
+        inFan.set(e);
+        mesh.faceVertices[DirectedEdgeMesh::prev(e)] = target;
+      }
     }
 
-    inputFile.close();
-  } else {
-    std::cout << "Error: failed to read file <"
-              << (std::string)filePath.filename() << ">" << std::endl;
-    return 1;
+    splitVertices += copies > 0;
+    addedVertices += copies;
   }
 
-  // PHASE 2: DATA CONSTRUCTION
-  // making sure things are nice and tidy to do testing
-  for (auto f : faceInput) {
-    for (auto vID : f.vertexIDs) {
-      vertexInput[vID].degree++;
-    }
+  return splitVertices;
+}
+
+// close a hole with a fan of faces around a new vertex at its centroid, into
+// the vertex centreID and the faces from firstFace on, which must exist
+void fillHoleFan(DirectedEdgeMesh &mesh, const std::vector<int> &h,
+                 int centreID, int firstFace) {
+  // take the position of each vertex to calculate the center
+  int holeDegree = 0;
+  Cartesian3 vertexTotal{};
+
+  for (auto e : h) {
+    vertexTotal = vertexTotal + mesh.position(mesh.to(e));
+    holeDegree++;
   }
 
-  // construct the directed edges
-  int j = 0;
-  for (size_t i = 0; i < faceInput.size(); i++) {
-    std::vector<int> v = faceInput[i].vertexIDs;
+  Cartesian3 centreVertex = vertexTotal / (float)holeDegree;
 
-    // number is respect the current face
-    DirectedEdge e0(j + 0, v[0], i);
-    DirectedEdge e1(j + 1, v[1], i);
-    DirectedEdge e2(j + 2, v[2], i);
+  mesh.setPosition(centreID, centreVertex);
 
-    dirEdgeInput.push_back(e0);
-    dirEdgeInput.push_back(e1);
-    dirEdgeInput.push_back(e2);
-    j += 3;
-  }
+  // check the start point of the new directed edges
+  // we'll need this to set the twins and the FDE of the new vertex
+  int startEdgeID = 3 * firstFace;
 
-  if (dirEdgeInput.size() != halfInput.size()) {
-    std::cout << "Error: insufficient number of edge pairings specified"
-              << std::endl;
-    return 1;
-  }
+  // construct # faces equal to the whole degree
+  for (int i = 0; i < holeDegree; i++) {
 
-  if (fdeInput.size() != vertexInput.size()) {
-    std::cout << "Error: insufficient number of vertices or FDEs specified"
-              << std::endl;
-    return 1;
-  }
+    // form the vertices of the triangle
+    int v0 = mesh.from(h[i]);
+    int v1 = centreID;
+    int v2 = mesh.to(h[i]);
 
-  int e = 0;
-  for (auto &de : dirEdgeInput) {
-    de.twinID = halfInput[e];
-    e++;
+    // after finding the average center, compute faces
+    // generate a face with its respective directed edges
+    mesh.setFace(firstFace + i, v0, v1, v2);
   }
-  e = 0;
-  for (auto &v : vertexInput) {
-    v.fdeID = fdeInput[e];
-    e++;
+
+  // pair the new edges within the fan, face i has the edges
+  // to(h[i]) -> from(h[i]) along the rim, from(h[i]) -> centre and
+  // centre -> to(h[i]), and the hole runs backwards, so to(h[i + 1]) is
+  // from(h[i])
+  for (int i = 0; i < holeDegree; i++) {
+    int rimEdge = startEdgeID + 3 * i;
+    int spokeIn = rimEdge + 1;
+    int spokeOut = startEdgeID + 3 * ((i + 1) % holeDegree) + 2;
+
+    mesh.otherHalves[rimEdge] = h[i];
+    mesh.otherHalves[h[i]] = rimEdge;
+    mesh.otherHalves[spokeIn] = spokeOut;
+    mesh.otherHalves[spokeOut] = spokeIn;
   }
 
-  std::vector<std::vector<int>> holes;
+  // the first face's edge out of the centre
+  mesh.firstDirectedEdges[centreID] = startEdgeID + 2;
+}
 
-  for (auto &d : dirEdgeInput) {
-    std::vector<int> boundaryEdgeIDs;
+// close a hole of three or more edges with its minimum-weight triangulation
+// into the hole size - 2 faces from firstFace on, no vertices are added
+void fillHoleMinimumWeight(DirectedEdgeMesh &mesh, const std::vector<int> &h,
+                           int firstFace) {
+  int holeDegree = h.size();
+  int startEdgeID = 3 * firstFace;
+  std::vector<HoleTriangle> triangles = minimumWeightTriangulation(mesh, h);
+
+  for (size_t f = 0; f < triangles.size(); f++) {
+    const HoleTriangle &t = triangles[f];
+    mesh.setFace(firstFace + f, mesh.to(h[t.a]), mesh.to(h[t.b]),
+                 mesh.to(h[t.c]));
+  }
 
-    // we've found another half
-    if (d.twinID == -1 && !d.isVisited) {
+  // an edge between neighbouring loop positions closes a boundary edge, any
+  // other edge is a diagonal shared by two new faces, and both are found by
+  // loop position, so a vertex that is on the loop twice is paired correctly
+  std::unordered_map<int64_t, int> diagonals;
+  diagonals.reserve(holeDegree);
 
-      int startID = d.id;
-      int nextStartID = -1;
+  for (size_t f = 0; f < triangles.size(); f++) {
+    const HoleTriangle &t = triangles[f];
+    const int edgePositions[3][2] = {{t.c, t.a}, {t.a, t.b}, {t.b, t.c}};
 
-      while (nextStartID != startID) {
-        if (nextStartID != -1)
-          nextStartID = oneBoundary(dirEdgeInput, nextStartID);
-        else
-          nextStartID = oneBoundary(dirEdgeInput, startID);
+    for (int i = 0; i < 3; i++) {
+      int e = startEdgeID + 3 * f + i;
+      int from = edgePositions[i][0], to = edgePositions[i][1];
 
-        boundaryEdgeIDs.push_back(nextStartID);
+      if (to == (from + 1) % holeDegree) {
+        mesh.otherHalves[e] = h[from];
+        mesh.otherHalves[h[from]] = e;
+        continue;
       }
 
-      std::cout << "found hole: [ ";
-      for (auto e : boundaryEdgeIDs) {
-        dirEdgeInput[e].isVisited = true;
-        std::cout << e << " ";
+      auto twin = diagonals.find((int64_t)to * holeDegree + from);
+      if (twin != diagonals.end()) {
+        mesh.otherHalves[e] = twin->second;
+        mesh.otherHalves[twin->second] = e;
+        diagonals.erase(twin);
+      } else {
+        diagonals[(int64_t)from * holeDegree + to] = e;
       }
-      std::cout << "]" << std::endl;
+    }
+  }
+}
 
-      holes.push_back(boundaryEdgeIDs);
+int main(int argc, char *argv[]) {
+  // -b writes the binary .diredge format instead of text
+  bool binaryOutput = false;
+  // -w fills holes with a minimum-weight triangulation instead of a fan
+  bool minimumWeight = false;
+  // -f refines the filled holes and fairs them with this energy, 0 leaves
+  // the fill as it is
+  int fairingOrder = 0;
+  // -p splits pinch vertices before the holes are found
+  bool splitPinches = false;
+
+  int arg = 1;
+  for (; arg < argc - 1; arg++) {
+    std::string option(argv[arg]);
+
+    if (option == "-b") {
+      binaryOutput = true;
+    } else if (option == "-w") {
+      minimumWeight = true;
+    } else if (option == "-p") {
+      splitPinches = true;
+    } else if (option == "-f" && arg + 1 < argc - 1) {
+      std::string energy(argv[++arg]);
+      if (energy == "membrane") {
+        fairingOrder = MEMBRANE_FAIRING;
+      } else if (energy == "thinplate") {
+        fairingOrder = THIN_PLATE_FAIRING;
+      } else {
+        std::cout << "Error: the fairing energy must be membrane or thinplate"
+                  << std::endl;
+        return 1;
+      }
+    } else {
+      break;
     }
   }
 
-  // if there are holes, find the central vertex and perform insertion
-  if (!holes.empty()) {
+  if (arg != argc - 1) {
+    std::cout << "Usage: ./meshRepair [-b] [-p] [-w] [-f membrane|thinplate] "
+                 "<filepath>"
+              << std::endl;
+    std::cout << "  -f refines each filled hole to the density of the mesh "
+                 "around it, then\n"
+                 "     fairs the vertices inside, for fan and -w fills alike\n"
+                 "  exits with 2 when boundary chains that do not close are "
+                 "left open"
+              << std::endl;
+    return 0;
+  }
 
-    for (auto h : holes) {
+  if (binaryOutput && !littleEndianHost()) {
+    std::cout << "Error: " << BINARY_HOST_ERROR << std::endl;
+    return 1;
+  }
 
-      // take the position of each vertex to calculate the center
-      int holeDegree = 0;
-      Cartesian3 vertexTotal{};
+  std::filesystem::path filePath(argv[arg]);
 
-      for (auto e : h) {
-        vertexTotal = vertexTotal + vertexInput[dirEdgeInput[e].vertexID].point;
-        //std::cout << "Boundary point: "
-        //          << vertexInput[dirEdgeInput[e].vertexID].point << std::endl;
-        holeDegree++;
-      }
+  if (filePath.extension().compare(".diredge") != 0) {
+    std::cout << "Error: .diredge file type required for manifold test"
+              << std::endl;
+    return 1;
+  }
 
-      Cartesian3 centreVertex = vertexTotal / (float)holeDegree;
+  // PHASE 1: Parse the file
+  DirectedEdgeMesh mesh;
+  std::string error;
 
-      int centreID = vertexInput.size();
+  if (!readMeshRecords(filePath, mesh, error)) {
+    std::cout << "Error: " << error << std::endl;
+    return 1;
+  }
 
-      vertexInput.push_back(
-          Vertex(centreID, centreVertex.x, centreVertex.y, centreVertex.z));
+  if ((int)mesh.otherHalves.size() != mesh.edgeCount()) {
+    std::cout << "Error: insufficient number of edge pairings specified"
+              << std::endl;
+    return 1;
+  }
 
-      // std::cout << "Average center: " << centreVertex << std::endl;
+  if ((int)mesh.firstDirectedEdges.size() != mesh.vertexCount()) {
+    std::cout << "Error: insufficient number of vertices or FDEs specified"
+              << std::endl;
+    return 1;
+  }
 
-	  // check the start point of the new directed edges
-	  // we'll need this to set the FDE of the new vertex
-      int startEdgeID = dirEdgeInput.size();
+  // split the pinch vertices first, so that boundary loops which met at one
+  // are filled separately
+  if (splitPinches) {
+    int addedVertices = 0;
+    int splitVertices = splitPinchVertices(mesh, addedVertices);
+    std::cout << "split " << splitVertices << " pinch vertices, adding "
+              << addedVertices << " vertices" << std::endl;
+  }
 
-      // construct # faces equal to the whole degree
-      for (int i = 0; i < holeDegree; i++) {
+  // PHASE 2: find the boundary loops
+  std::vector<std::vector<int>> holes;
+  int inputEdges = mesh.edgeCount();
+  Bitset edgeVisited(inputEdges);
+  BoundaryMap boundary(mesh);
+
+  // such loops are still filled, each from the fan of faces it runs along
+  std::vector<int> sharedVertices = boundary.sharedVertices();
+  if (!sharedVertices.empty()) {
+    std::cout << "Warning: boundary loops meet at " << sharedVertices.size()
+              << " vertices (first:";
+    for (size_t i = 0; i < sharedVertices.size() && i < 10; i++)
+      std::cout << " " << sharedVertices[i];
+    std::cout << (sharedVertices.size() > 10 ? " ...)" : ")") << std::endl;
+  }
 
-        // form the vertices of the triangle (question: how do we access the new vertices?)
-        int v0 = dirEdgeInput[dirEdgeInput[h[i]].prev()].vertexID;
-        int v1 = centreID;
-        int v2 = dirEdgeInput[h[i]].vertexID;
+  // chains of boundary edges that do not close, e.g. through other halves
+  // that do not point back, are left open and the loops that close are still
+  // filled
+  int openChains = 0;
+
+  // a boundary edge that no other boundary edge follows ends a chain, so the
+  // chains are traced from their ends first, each whole and once, and the
+  // edges left over are on loops
+  Bitset followed(inputEdges);
+  for (int e = 0; e < inputEdges; e++) {
+    if (mesh.otherHalves[e] == -1) {
+      int previous = boundary.previous(e);
+      if (previous != -1)
+        followed.set(previous);
+    }
+  }
 
-        // note, we can't push this back yet as we still need the halfEdgeID?
-        int faceID = faceInput.size();
-        int edgeID = dirEdgeInput.size();
+  // trace the boundary back from edge d, false if it does not close
+  auto traceBoundary = [&](int d, std::vector<int> &boundaryEdgeIDs) {
+    // each loop is traced backwards, ending with the edge it started from
+    int e = d;
+    do {
+      int previous = boundary.previous(e);
+
+      if (previous == -1 || edgeVisited.test(previous)) {
+        std::cout << "Warning: the boundary through edge " << d
+                  << " does not close into a loop, it stops at vertex "
+                  << mesh.from(e) << " after " << boundaryEdgeIDs.size() + 1
+                  << " edges and is left open" << std::endl;
+        edgeVisited.set(d);
+        return false;
+      }
 
-        // after finding the average center, compute faces
-        // generate a face with its respective directed edges
-        Face insertFace(faceID, std::vector<int>{v0, v1, v2});
-        faceInput.push_back(insertFace);
+      e = previous;
+      edgeVisited.set(e);
+      boundaryEdgeIDs.push_back(e);
+    } while (e != d);
 
-        DirectedEdge e0(edgeID, v0, faceID);
-        DirectedEdge e1(edgeID + 1, v1, faceID);
-        DirectedEdge e2(edgeID + 2, v2, faceID);
+    return true;
+  };
 
-        dirEdgeInput.push_back(e0);
-        dirEdgeInput.push_back(e1);
-        dirEdgeInput.push_back(e2);
-      }
+  for (int pass = 0; pass < 2; pass++) {
+    for (int d = 0; d < inputEdges; d++) {
+      // we've found another half
+      if (mesh.otherHalves[d] != -1 || edgeVisited.test(d) ||
+          (pass == 0 && followed.test(d)))
+        continue;
 
-	  // set the twins for each of the new edges
-      for (auto &d1 : dirEdgeInput) {
+      std::vector<int> boundaryEdgeIDs;
+      if (!traceBoundary(d, boundaryEdgeIDs)) {
+        openChains++;
+        continue;
+      }
 
-        if (d1.twinID != -1)
-          continue;
+      std::cout << "found hole: [ ";
+      for (auto e : boundaryEdgeIDs)
+        std::cout << e << " ";
+      std::cout << "]" << std::endl;
 
-        for (auto &d2 : dirEdgeInput) {
+      holes.push_back(boundaryEdgeIDs);
+    }
+  }
 
-          if (dirEdgeInput[d1.prev()].vertexID == d2.vertexID &&
-              dirEdgeInput[d2.prev()].vertexID == d1.vertexID) {
+  // fill each hole, holes too small to triangulate get a fan either way
+  // the new vertices and faces of every hole are numbered up front, in hole
+  // order, so the holes can be filled at the same time into their own ids and
+  // the mesh comes out the same as filling them one after another
+  auto triangulated = [&](const std::vector<int> &h) {
+    return minimumWeight && h.size() >= 3;
+  };
+
+  std::vector<int> firstVertex(holes.size() + 1, mesh.vertexCount());
+  std::vector<int> firstFace(holes.size() + 1, mesh.faceCount());
+  for (size_t i = 0; i < holes.size(); i++) {
+    int holeDegree = holes[i].size();
+    firstVertex[i + 1] = firstVertex[i] + (triangulated(holes[i]) ? 0 : 1);
+    firstFace[i + 1] =
+        firstFace[i] + (triangulated(holes[i]) ? holeDegree - 2 : holeDegree);
+  }
 
-            if (d2.twinID != -1) {
-              continue;
-            }
+  mesh.grow(firstVertex.back() - mesh.vertexCount(),
+            firstFace.back() - mesh.faceCount());
+
+  // each hole only writes its own new ids and the other halves of its own
+  // boundary edges, and only reads the input mesh
+  parallelQueue(holes.size(), threadCount(), [&](size_t i) {
+    if (triangulated(holes[i]))
+      fillHoleMinimumWeight(mesh, holes[i], firstFace[i]);
+    else
+      fillHoleFan(mesh, holes[i], firstVertex[i], firstFace[i]);
+  });
+
+  // a fill has at most one vertex inside, so the patches are refined first
+  // to give the fairing vertices to move, then the new vertices are faired
+  // with every vertex of the input mesh fixed
+  if (fairingOrder != 0) {
+    int addedVertices = refinePatch(mesh, firstFace[0]);
+    std::cout << "refined the filled holes, adding " << addedVertices
+              << " vertices" << std::endl;
+  }
 
-            d1.twinID = d2.id;
-            d2.twinID = d1.id;
+  if (fairingOrder != 0 && mesh.vertexCount() > firstVertex[0]) {
+    std::vector<int> newVertices;
+    for (int v = firstVertex[0]; v < mesh.vertexCount(); v++)
+      newVertices.push_back(v);
 
-            // std::cout << "OtherHalf " << d1.id << " " << d1.twinID << std::endl;
-            break;
-          }
-        }
-      }
+    FairingResult faired = fairVertices(mesh, newVertices, fairingOrder);
+    std::cout << "faired " << faired.vertices << " vertices in "
+              << faired.iterations << " iterations" << std::endl;
 
-	  // set the new FDE for the added vertex
-	  // vertexInput.back().fdeID 
-	  for(size_t i = startEdgeID; i < dirEdgeInput.size(); i++){
-		int currentVertexTo = dirEdgeInput[dirEdgeInput[i].prev()].vertexID;
-		if(currentVertexTo == centreID){
-		  vertexInput.back().fdeID = dirEdgeInput[i].id;
-		  break;
-		}
-	  }
-    }
+    if (!faired.converged)
+      std::cout << "Warning: fairing stopped at a relative residual of "
+                << faired.residual << std::endl;
   }
 
+  // PHASE 3: take the repaired mesh as file output
   std::string objectName = (std::string)filePath.stem();
   std::string outputFileName = objectName + "_fixed.diredge";
-  std::ofstream outputFile(outputFileName, std::ios::out);
-
-  if (outputFile.is_open()) {
-    outputFile << "# University of Leeds 2022-2023" << std::endl;
-    outputFile << "# COMP 5812 Assignment 1" << std::endl;
-    outputFile << "# Oliver Cheung " << std::endl;
-    outputFile << "# 201597566" << std::endl;
-    outputFile << "#" << std::endl;
-    outputFile << "# Object Name: " << objectName << std::endl;
-    outputFile << "# Vertices=" << vertexInput.size()
-               << " Faces=" << faceInput.size() << std::endl;
-    outputFile << "#" << std::endl;
-
-    for (auto v : vertexInput) {
-      outputFile << "Vertex " << v.id << "\t" << v.point.x << " " << v.point.y << " " << v.point.z << std::endl;
-    }
 
-	for (auto v : vertexInput) {
-	  outputFile << "FirstDirectedEdge " << v.id << "\t" << v.fdeID
-				 << std::endl;
-	}
+  bool written = binaryOutput
+                     ? writeDiredgeBinary(outputFileName, mesh)
+                     : writeDiredgeText(outputFileName, objectName, mesh);
 
-    for (auto f : faceInput) {
-      outputFile << "Face " << f.id << "\t";
-      for (int i = 0; i < 3; i++) {
-        outputFile << f.vertexIDs[i] << " ";
-      }
-      outputFile << std::endl;
-    }
-
-    for (auto de : dirEdgeInput) {
-      outputFile << "OtherHalf " << de.id << "\t" << de.twinID << std::endl;
-    }
-
-    outputFile.close();
-
-    std::cout << "File <" << outputFileName << "> written to successfully!"
-              << std::endl;
-  } else {
+  if (!written) {
     std::cout << "Error: failed to write to a file: " << outputFileName
               << std::endl;
     return 1;
   }
 
+  std::cout << "File <" << outputFileName << "> written to successfully!"
+            << std::endl;
+
+  // a partial repair still writes the mesh, but exits with its own status
+  if (openChains > 0) {
+    std::cout << "Warning: " << openChains
+              << " open boundary chains were not filled, the repair is partial"
+              << std::endl;
+    return 2;
+  }
   return 0;
 }
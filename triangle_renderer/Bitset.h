@@ -0,0 +1,26 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// a fixed number of flags packed 64 to a word, for marking vertices, edges
+// or faces as visited without widening the mesh arrays
+class Bitset
+{
+ public:
+  Bitset(size_t size = 0) : words((size + 63) / 64, 0), bits(size) {}
+
+  size_t size() const { return bits; }
+
+  bool test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+  void set(size_t i) { words[i / 64] |= (uint64_t)1 << (i % 64); }
+  void reset(size_t i) { words[i / 64] &= ~((uint64_t)1 << (i % 64)); }
+
+ private:
+  std::vector<uint64_t> words;
+  size_t bits;
+};
+
+#endif
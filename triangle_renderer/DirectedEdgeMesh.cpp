@@ -0,0 +1,124 @@
+#include "DirectedEdgeMesh.h"
+
+int DirectedEdgeMesh::addVertex(const Cartesian3 &point) {
+  int vertex = vertexCount();
+  positions.push_back(point.x);
+  positions.push_back(point.y);
+  positions.push_back(point.z);
+  firstDirectedEdges.push_back(-1);
+  return vertex;
+}
+
+int DirectedEdgeMesh::addFace(int v0, int v1, int v2) {
+  int face = faceCount();
+  faceVertices.push_back(v0);
+  faceVertices.push_back(v1);
+  faceVertices.push_back(v2);
+  otherHalves.insert(otherHalves.end(), 3, -1);
+  return face;
+}
+
+void DirectedEdgeMesh::grow(int vertices, int faces) {
+  positions.resize(positions.size() + 3 * (size_t)vertices, 0.0f);
+  firstDirectedEdges.resize(firstDirectedEdges.size() + vertices, -1);
+  faceVertices.resize(faceVertices.size() + 3 * (size_t)faces, -1);
+  otherHalves.resize(otherHalves.size() + 3 * (size_t)faces, -1);
+}
+
+namespace {
+
+bool checkArrays(const int32_t *faceVertices, int edges, int vertices,
+                 const int32_t *firstDirectedEdges, int firstCount,
+                 const int32_t *otherHalves, int halfCount,
+                 std::string &error) {
+  for (int e = 0; e < edges; e++) {
+    if (faceVertices[e] < 0 || faceVertices[e] >= vertices) {
+      error = "face " + std::to_string(e / 3) + " uses vertex " +
+              std::to_string(faceVertices[e]) + ", which does not exist";
+      return false;
+    }
+  }
+
+  for (int v = 0; v < firstCount; v++) {
+    if (firstDirectedEdges[v] < -1 || firstDirectedEdges[v] >= edges) {
+      error = "first directed edge of vertex " + std::to_string(v) +
+              " is out of range";
+      return false;
+    }
+  }
+
+  for (int e = 0; e < halfCount; e++) {
+    if (otherHalves[e] < -1 || otherHalves[e] >= edges) {
+      error = "other half of edge " + std::to_string(e) + " is out of range";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::vector<int> countDegrees(const int32_t *faceVertices, int edges,
+                              int vertices) {
+  std::vector<int> degrees(vertices, 0);
+  for (int e = 0; e < edges; e++)
+    degrees[faceVertices[e]]++;
+  return degrees;
+}
+
+} // namespace
+
+void DirectedEdgeMesh::fanEdges(int start, std::vector<int> &fan,
+                                int limit) const {
+  int v = from(start);
+  size_t first = fan.size();
+  auto full = [&] { return fan.size() - first >= (size_t)limit; };
+
+  int e = start;
+  while (!full()) {
+    fan.push_back(e);
+    e = otherHalves[prev(e)];
+    if (e == start)
+      return;
+    if (e == -1 || from(e) != v)
+      break;
+  }
+
+  e = start;
+  while (!full()) {
+    e = otherHalves[e];
+    if (e == -1)
+      return;
+
+    e = next(e);
+    if (from(e) != v)
+      return;
+    fan.push_back(e);
+  }
+}
+
+std::vector<int> DirectedEdgeMesh::vertexDegrees() const {
+  return countDegrees(faceVertices.data(), edgeCount(), vertexCount());
+}
+
+bool DirectedEdgeMesh::checkIndices(std::string &error) const {
+  return checkArrays(faceVertices.data(), edgeCount(), vertexCount(),
+                     firstDirectedEdges.data(), firstDirectedEdges.size(),
+                     otherHalves.data(), otherHalves.size(), error);
+}
+
+MeshView::MeshView(const DirectedEdgeMesh &mesh)
+    : positions(mesh.positions.data()),
+      firstDirectedEdges(mesh.firstDirectedEdges.data()),
+      faceVertices(mesh.faceVertices.data()),
+      otherHalves(mesh.otherHalves.data()), vertices(mesh.vertexCount()),
+      faces(mesh.faceCount()) {}
+
+std::vector<int> MeshView::vertexDegrees() const {
+  return countDegrees(faceVertices, edgeCount(), vertexCount());
+}
+
+bool MeshView::checkIndices(std::string &error) const {
+  return checkArrays(faceVertices, edgeCount(), vertexCount(),
+                     firstDirectedEdges, vertexCount(), otherHalves,
+                     edgeCount(), error);
+}
@@ -0,0 +1,126 @@
+#ifndef DIRECTED_EDGE_MESH_H
+#define DIRECTED_EDGE_MESH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Cartesian3.h"
+
+// a triangle mesh in the directed edge structure, stored as flat arrays
+//
+// directed edge e belongs to face e / 3 and points to the vertex
+// faceVertices[e], so the face, next and previous edge of any edge are found
+// by arithmetic and only the other halves and first directed edges are stored
+class DirectedEdgeMesh
+{
+ public:
+  // x, y, z of each vertex
+  std::vector<float> positions;
+  // first directed edge leaving each vertex, -1 for a vertex without faces
+  std::vector<int32_t> firstDirectedEdges;
+  // three vertex ids per face, counter-clockwise
+  std::vector<int32_t> faceVertices;
+  // the opposing half of each directed edge, -1 on a boundary
+  std::vector<int32_t> otherHalves;
+
+  int vertexCount() const { return positions.size() / 3; }
+  int faceCount() const { return faceVertices.size() / 3; }
+  int edgeCount() const { return faceVertices.size(); }
+
+  static int next(int edge) { return edge / 3 * 3 + (edge + 1) % 3; }
+  static int prev(int edge) { return edge / 3 * 3 + (edge + 2) % 3; }
+  static int face(int edge) { return edge / 3; }
+
+  // the vertices an edge runs between
+  int from(int edge) const { return faceVertices[prev(edge)]; }
+  int to(int edge) const { return faceVertices[edge]; }
+
+  Cartesian3 position(int vertex) const {
+    return Cartesian3(positions[3 * vertex], positions[3 * vertex + 1],
+                      positions[3 * vertex + 2]);
+  }
+
+  void setPosition(int vertex, const Cartesian3 &point) {
+    positions[3 * vertex] = point.x;
+    positions[3 * vertex + 1] = point.y;
+    positions[3 * vertex + 2] = point.z;
+  }
+
+  // append a vertex without a first directed edge, returns its id
+  int addVertex(const Cartesian3 &point);
+
+  // append a face with three unpaired directed edges, returns its id
+  int addFace(int v0, int v1, int v2);
+
+  // append vertices at the origin without first directed edges, and faces of
+  // vertex -1 with unpaired edges, to be filled in with setPosition and
+  // setFace, so that separate threads can each fill in their own ids
+  void grow(int vertices, int faces);
+
+  // set the vertices of a face, its other halves are left as they are
+  void setFace(int face, int v0, int v1, int v2) {
+    faceVertices[3 * face] = v0;
+    faceVertices[3 * face + 1] = v1;
+    faceVertices[3 * face + 2] = v2;
+  }
+
+  // number of face corners at each vertex
+  std::vector<int> vertexDegrees() const;
+
+  // append the directed edges leaving the vertex that start leaves, in the
+  // fan of faces that start is in: rotating one way from start until the fan
+  // closes, and when it ends on a boundary, from start the other way too
+  // the walk stops at an edge that does not leave the vertex, as through
+  // other halves that do not point back, and after limit edges
+  void fanEdges(int start, std::vector<int> &fan, int limit) const;
+  void fanEdges(int start, std::vector<int> &fan) const {
+    fanEdges(start, fan, edgeCount());
+  }
+
+  // check that every stored index is in range, so that the accessors above
+  // can be used unchecked, describes the first bad index in error
+  bool checkIndices(std::string &error) const;
+};
+
+// read-only view of the arrays of a complete directed edge mesh, pointing into
+// a DirectedEdgeMesh or straight into a mapped binary .diredge
+// a view is four pointers and two counts, so it is passed by value and
+// traversing it never copies or allocates
+class MeshView
+{
+ public:
+  const float *positions = nullptr;
+  const int32_t *firstDirectedEdges = nullptr;
+  const int32_t *faceVertices = nullptr;
+  const int32_t *otherHalves = nullptr;
+  int vertices = 0;
+  int faces = 0;
+
+  MeshView() {}
+  // the mesh must have a first directed edge per vertex and an other half
+  // per edge, and outlive the view
+  MeshView(const DirectedEdgeMesh &mesh);
+
+  int vertexCount() const { return vertices; }
+  int faceCount() const { return faces; }
+  int edgeCount() const { return 3 * faces; }
+
+  static int next(int edge) { return DirectedEdgeMesh::next(edge); }
+  static int prev(int edge) { return DirectedEdgeMesh::prev(edge); }
+  static int face(int edge) { return DirectedEdgeMesh::face(edge); }
+
+  int from(int edge) const { return faceVertices[prev(edge)]; }
+  int to(int edge) const { return faceVertices[edge]; }
+
+  Cartesian3 position(int vertex) const {
+    return Cartesian3(positions[3 * vertex], positions[3 * vertex + 1],
+                      positions[3 * vertex + 2]);
+  }
+
+  // as for DirectedEdgeMesh
+  std::vector<int> vertexDegrees() const;
+  bool checkIndices(std::string &error) const;
+};
+
+#endif
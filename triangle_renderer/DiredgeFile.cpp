@@ -0,0 +1,173 @@
+#include <cstring>
+#include <fstream>
+
+#include "DiredgeFile.h"
+
+namespace {
+
+const char MAGIC[8] = {'D', 'I', 'R', 'E', 'D', 'G', 'E', '\0'};
+const size_t HEADER_SIZE = 32;
+
+size_t align16(size_t offset) { return (offset + 15) & ~(size_t)15; }
+
+// byte offsets of the four arrays and the end of the file
+struct Layout {
+  size_t positions, firstDirectedEdges, faceVertices, otherHalves, size;
+
+  Layout(size_t vertexCount, size_t faceCount) {
+    positions = HEADER_SIZE;
+    firstDirectedEdges = align16(positions + 12 * vertexCount);
+    faceVertices = align16(firstDirectedEdges + 4 * vertexCount);
+    otherHalves = align16(faceVertices + 12 * faceCount);
+    size = otherHalves + 12 * faceCount;
+  }
+};
+
+} // namespace
+
+bool littleEndianHost() {
+  const uint16_t probe = 1;
+  char low;
+  std::memcpy(&low, &probe, 1);
+  return low == 1;
+}
+
+bool isBinaryDiredge(const char *begin, const char *end) {
+  return end - begin >= (long)sizeof(MAGIC) &&
+         std::memcmp(begin, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool viewBinaryDiredge(const char *begin, const char *end, MeshView &view,
+                       std::string &error) {
+  if (!littleEndianHost()) {
+    error = BINARY_HOST_ERROR;
+    return false;
+  }
+
+  if (end - begin < (long)HEADER_SIZE || !isBinaryDiredge(begin, end)) {
+    error = "not a binary .diredge file";
+    return false;
+  }
+
+  uint32_t header[3];
+  std::memcpy(header, begin + 8, sizeof(header));
+
+  if (header[0] != DIREDGE_BINARY_VERSION) {
+    error = "unsupported binary .diredge version " + std::to_string(header[0]);
+    return false;
+  }
+
+  if (header[1] > INT32_MAX / 3 || header[2] > INT32_MAX / 3) {
+    error = "binary .diredge counts out of range";
+    return false;
+  }
+
+  Layout layout(header[1], header[2]);
+  if ((size_t)(end - begin) < layout.size) {
+    error = "binary .diredge file is truncated";
+    return false;
+  }
+
+  view.vertices = header[1];
+  view.faces = header[2];
+  view.positions = (const float *)(begin + layout.positions);
+  view.firstDirectedEdges = (const int32_t *)(begin + layout.firstDirectedEdges);
+  view.faceVertices = (const int32_t *)(begin + layout.faceVertices);
+  view.otherHalves = (const int32_t *)(begin + layout.otherHalves);
+  return true;
+}
+
+bool parseBinaryDiredge(const char *begin, const char *end,
+                        DirectedEdgeMesh &mesh, std::string &error) {
+  MeshView view;
+  if (!viewBinaryDiredge(begin, end, view, error))
+    return false;
+
+  int vertices = view.vertexCount();
+  int edges = view.edgeCount();
+  mesh.positions.assign(view.positions, view.positions + 3 * vertices);
+  mesh.firstDirectedEdges.assign(view.firstDirectedEdges,
+                                 view.firstDirectedEdges + vertices);
+  mesh.faceVertices.assign(view.faceVertices, view.faceVertices + edges);
+  mesh.otherHalves.assign(view.otherHalves, view.otherHalves + edges);
+  return true;
+}
+
+bool writeDiredgeBinary(const std::string &path, const DirectedEdgeMesh &mesh) {
+  if (!littleEndianHost())
+    return false;
+
+  uint32_t vertexCount = mesh.vertexCount();
+  uint32_t faceCount = mesh.faceCount();
+
+  // every array must be complete for the counts in the header
+  if (mesh.firstDirectedEdges.size() != vertexCount ||
+      mesh.otherHalves.size() != 3 * (size_t)faceCount)
+    return false;
+
+  Layout layout(vertexCount, faceCount);
+  std::vector<char> file(layout.size, 0);
+
+  uint32_t header[3] = {DIREDGE_BINARY_VERSION, vertexCount, faceCount};
+  std::memcpy(file.data(), MAGIC, sizeof(MAGIC));
+  std::memcpy(file.data() + 8, header, sizeof(header));
+
+  // the mesh arrays have the file layout already
+  std::memcpy(file.data() + layout.positions, mesh.positions.data(),
+              12 * (size_t)vertexCount);
+  std::memcpy(file.data() + layout.firstDirectedEdges,
+              mesh.firstDirectedEdges.data(), 4 * (size_t)vertexCount);
+  std::memcpy(file.data() + layout.faceVertices, mesh.faceVertices.data(),
+              12 * (size_t)faceCount);
+  std::memcpy(file.data() + layout.otherHalves, mesh.otherHalves.data(),
+              12 * (size_t)faceCount);
+
+  std::ofstream outputFile(path, std::ios::out | std::ios::binary);
+  if (!outputFile.is_open())
+    return false;
+
+  outputFile.write(file.data(), file.size());
+  return (bool)outputFile;
+}
+
+bool writeDiredgeText(const std::string &path, const std::string &objectName,
+                      const DirectedEdgeMesh &mesh) {
+  std::ofstream outputFile(path, std::ios::out);
+  if (!outputFile.is_open())
+    return false;
+
+  outputFile << "# University of Leeds 2022-2023\n";
+  outputFile << "# COMP 5812 Assignment 1\n";
+  outputFile << "# Oliver Cheung \n";
+  outputFile << "# 201597566\n";
+  outputFile << "#\n";
+  outputFile << "# Object Name: " << objectName << "\n";
+  outputFile << "# Vertices=" << mesh.vertexCount()
+             << " Faces=" << mesh.faceCount() << "\n";
+  outputFile << "#\n";
+
+  for (int v = 0; v < mesh.vertexCount(); v++) {
+    outputFile << "Vertex " << v << "\t" << mesh.positions[3 * v] << " "
+               << mesh.positions[3 * v + 1] << " " << mesh.positions[3 * v + 2]
+               << "\n";
+  }
+
+  for (size_t v = 0; v < mesh.firstDirectedEdges.size(); v++) {
+    outputFile << "FirstDirectedEdge " << v << "\t"
+               << mesh.firstDirectedEdges[v] << "\n";
+  }
+
+  for (int f = 0; f < mesh.faceCount(); f++) {
+    outputFile << "Face " << f << "\t";
+    for (int i = 0; i < 3; i++) {
+      outputFile << mesh.faceVertices[3 * f + i] << " ";
+    }
+    outputFile << "\n";
+  }
+
+  for (size_t e = 0; e < mesh.otherHalves.size(); e++) {
+    outputFile << "OtherHalf " << e << "\t" << mesh.otherHalves[e] << "\n";
+  }
+
+  return (bool)outputFile;
+}
@@ -0,0 +1,50 @@
+#ifndef DIREDGE_FILE_H
+#define DIREDGE_FILE_H
+
+#include <cstdint>
+#include <string>
+
+#include "DirectedEdgeMesh.h"
+
+// binary .diredge layout, version 1, all values little-endian:
+//
+//   offset  0  char[8]   magic "DIREDGE\0"
+//   offset  8  uint32    version
+//   offset 12  uint32    vertex count V
+//   offset 16  uint32    face count F
+//   offset 20  uint32[3] reserved, zero
+//   offset 32  float32   positions[3V]
+//              int32     firstDirectedEdges[V]
+//              int32     faceVertices[3F]
+//              int32     otherHalves[3F]
+//
+// each array starts on a 16 byte boundary, padded with zeros, so a mapped
+// file can be used in place
+const uint32_t DIREDGE_BINARY_VERSION = 1;
+
+// the arrays are copied without swapping bytes, so binary files can only be
+// read and written on a little-endian host
+bool littleEndianHost();
+const char *const BINARY_HOST_ERROR =
+    "binary .diredge files need a little-endian host";
+
+// true if the buffer starts with the binary magic
+bool isBinaryDiredge(const char *begin, const char *end);
+
+// check the header and sizes and point a view at the arrays in the buffer
+// the buffer must be 4 byte aligned, which a mapped file always is, and the
+// indices are not checked (see MeshView::checkIndices)
+bool viewBinaryDiredge(const char *begin, const char *end, MeshView &view,
+                       std::string &error);
+
+// copy a binary buffer into the arrays of a mesh
+bool parseBinaryDiredge(const char *begin, const char *end,
+                        DirectedEdgeMesh &mesh, std::string &error);
+
+// write a mesh in either format, objectName goes in the text header
+// the binary writer fails on a big-endian host, which callers check first
+bool writeDiredgeBinary(const std::string &path, const DirectedEdgeMesh &mesh);
+bool writeDiredgeText(const std::string &path, const std::string &objectName,
+                      const DirectedEdgeMesh &mesh);
+
+#endif
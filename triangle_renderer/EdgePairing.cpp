@@ -0,0 +1,158 @@
+#include <algorithm>
+
+#include "EdgePairing.h"
+#include "Hashing.h"
+#include "Parallel.h"
+
+namespace {
+
+int fromVertex(const std::vector<int> &faceVertices, int edge) {
+  return faceVertices[3 * (edge / 3) + (edge + 2) % 3];
+}
+
+} // namespace
+
+std::vector<int> firstDirectedEdges(const std::vector<int> &faceVertices,
+                                    int vertexCount) {
+  std::vector<int> firstEdges(vertexCount, -1);
+
+  // edges are visited in id order, so the first one seen is the lowest
+  for (int e = 0; e < (int)faceVertices.size(); e++) {
+    int from = fromVertex(faceVertices, e);
+    if (from >= 0 && from < vertexCount && firstEdges[from] == -1)
+      firstEdges[from] = e;
+  }
+
+  return firstEdges;
+}
+
+std::vector<int> pairOtherHalves(const std::vector<int> &faceVertices) {
+  int edges = faceVertices.size();
+  std::vector<int> otherHalves(edges, -1);
+
+  // one slot per distinct key, holding the key, its lowest unpaired edge and
+  // the chain of edges with that key in id order
+  std::vector<uint64_t> keys(tableSizeFor(edges));
+  std::vector<int> cursors(keys.size(), -1);
+  std::vector<int> nextWithKey(edges, -1);
+  std::vector<int> lastWithKey(keys.size(), -1);
+  size_t mask = keys.size() - 1;
+
+  auto slotFor = [&](uint64_t key) {
+    size_t slot = mixBits(key) & mask;
+    while (cursors[slot] != -1 && keys[slot] != key)
+      slot = (slot + 1) & mask;
+    return slot;
+  };
+
+  for (int e = 0; e < edges; e++) {
+    size_t slot = slotFor(edgeKey(fromVertex(faceVertices, e), faceVertices[e]));
+    if (cursors[slot] == -1) {
+      keys[slot] = edgeKey(fromVertex(faceVertices, e), faceVertices[e]);
+      cursors[slot] = e;
+    } else {
+      nextWithKey[lastWithKey[slot]] = e;
+    }
+    lastWithKey[slot] = e;
+  }
+
+  for (int e = 0; e < edges; e++) {
+    if (otherHalves[e] != -1)
+      continue;
+
+    size_t slot = slotFor(edgeKey(faceVertices[e], fromVertex(faceVertices, e)));
+    if (cursors[slot] == -1)
+      continue;
+
+    // paired edges never become unpaired, so the cursor only moves forward
+    int twin = cursors[slot];
+    while (twin != -1 && otherHalves[twin] != -1)
+      twin = nextWithKey[twin];
+
+    // an exhausted chain must keep its slot, park the cursor on its last edge
+    if (twin == -1) {
+      cursors[slot] = lastWithKey[slot];
+      continue;
+    }
+
+    cursors[slot] = twin;
+    otherHalves[e] = twin;
+    otherHalves[twin] = e;
+  }
+
+  return otherHalves;
+}
+
+std::vector<int> pairOtherHalvesSorted(const std::vector<int> &faceVertices,
+                                       EdgeRuns *runs) {
+  int edges = faceVertices.size();
+  std::vector<int> otherHalves(edges, -1);
+
+  std::vector<KeyIndex> records(edges);
+  parallelFor(edges, [&](size_t begin, size_t end, int) {
+    for (size_t e = begin; e < end; e++) {
+      int from = fromVertex(faceVertices, e);
+      int to = faceVertices[e];
+      records[e] = {edgeKey(std::min(from, to), std::max(from, to)), (int32_t)e};
+    }
+  });
+
+  // stable, so each run lists its edges in id order
+  parallelRadixSort(records);
+
+  std::vector<EdgeRuns> chunkRuns(parallelChunks(edges));
+  parallelFor(edges, [&](size_t begin, size_t end, int chunk) {
+    // a chunk handles the runs that start inside it
+    while (begin > 0 && begin < end && records[begin].key == records[begin - 1].key)
+      begin++;
+
+    EdgeRuns &counts = chunkRuns[chunk];
+    size_t start = begin;
+    while (start < end) {
+      size_t finish = start + 1;
+      while (finish < (size_t)edges && records[finish].key == records[start].key)
+        finish++;
+
+      size_t length = finish - start;
+      if (length == 1)
+        counts.boundary++;
+      else if (length == 2)
+        counts.manifold++;
+      else
+        counts.nonManifold++;
+
+      // visiting in id order, each edge takes the lowest unpaired edge of the
+      // opposite direction, so the k-th edge one way pairs with the k-th edge
+      // the other way, and an edge from a vertex to itself pairs with itself
+      int low = (int)(records[start].key >> 32);
+      size_t forward = start, backward = start;
+      for (;;) {
+        while (forward < finish &&
+               fromVertex(faceVertices, records[forward].index) != low)
+          forward++;
+        while (backward < finish && faceVertices[records[backward].index] != low)
+          backward++;
+        if (forward == finish || backward == finish)
+          break;
+
+        otherHalves[records[forward].index] = records[backward].index;
+        otherHalves[records[backward].index] = records[forward].index;
+        forward++;
+        backward++;
+      }
+
+      start = finish;
+    }
+  });
+
+  if (runs != nullptr) {
+    *runs = EdgeRuns();
+    for (auto &counts : chunkRuns) {
+      runs->boundary += counts.boundary;
+      runs->manifold += counts.manifold;
+      runs->nonManifold += counts.nonManifold;
+    }
+  }
+
+  return otherHalves;
+}
@@ -0,0 +1,50 @@
+#ifndef EDGE_PAIRING_H
+#define EDGE_PAIRING_H
+
+#include <cstdint>
+#include <vector>
+
+// directed edge e of a face list runs from faceVertices[prev(e)] to
+// faceVertices[e], with prev(e) = 3 * (e / 3) + (e + 2) % 3
+
+// key of the directed edge from -> to, from in the high word
+inline uint64_t edgeKey(int from, int to) {
+  return ((uint64_t)(uint32_t)from << 32) | (uint32_t)to;
+}
+
+// the lowest directed edge leaving each vertex, in one pass over the edges
+// vertices no face uses get -1
+std::vector<int> firstDirectedEdges(const std::vector<int> &faceVertices,
+                                    int vertexCount);
+
+// find the other half of every directed edge, -1 where there is none
+//
+// edges are visited in id order and each unpaired edge takes the lowest
+// unpaired edge running the opposite way, so edges shared by more than two
+// faces pair up first come first served
+//
+// the edges are chained by their (from, to) key in an open addressing hash
+// table, each chain keeps a cursor past its paired edges, so this is expected
+// O(E) rather than a scan of every edge pair
+std::vector<int> pairOtherHalves(const std::vector<int> &faceVertices);
+
+// undirected edges by the number of directed edges sharing them
+struct EdgeRuns {
+  // one directed edge
+  size_t boundary = 0;
+  // two directed edges
+  size_t manifold = 0;
+  // three or more
+  size_t nonManifold = 0;
+};
+
+// the same pairing as pairOtherHalves, found by sorting instead of hashing
+//
+// every directed edge gives a (min(u, v), max(u, v), edge) record, the records
+// are radix sorted in parallel so each undirected edge becomes a run of
+// records in edge id order, and each run is paired and counted into runs on
+// its own, which only touches memory in sequence
+std::vector<int> pairOtherHalvesSorted(const std::vector<int> &faceVertices,
+                                       EdgeRuns *runs = nullptr);
+
+#endif
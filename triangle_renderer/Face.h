@@ -1,13 +0,0 @@
-#include <vector>
-
-class Face
-{
- public:
-  int id = -1;
-  int halfEdgeID = -1; 
-  bool isVisited = false;
-
-  std::vector<int> vertexIDs;
-  Face();
-  Face(int faceID, std::vector<int> inputIDs);
-};
@@ -17,22 +17,25 @@
 ///////////////////////////////////////////////////
 
 #include "GeometricSurfaceFaceDS.h"
-#include <fstream>
 #include <iostream>
 #include <math.h>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 #ifdef __APPLE__
 #include <OpenGL/gl.h>
 #include <OpenGL/glu.h>
 #else
+// the buffer object calls are core since OpenGL 1.5, but only declared by
+// glext.h
+#define GL_GLEXT_PROTOTYPES
 #include <GL/gl.h>
 #include <GL/glu.h>
+#endif
 
 // added myself for rendering files in the .diredge format
 #include <filesystem>
-#include "Face.h"
-#include "Vertex.h"
-
-#endif
+#include "MeshParser.h"
 
 // constructor will initialise to safe values
 GeometricSurfaceFaceDS::
@@ -45,6 +48,10 @@ GeometricSurfaceFaceDS::
 
   // set the midpoint to the origin
   midPoint = Cartesian3(0.0, 0.0, 0.0);
+
+  // no buffers until the first render
+  vertexBuffer = normalBuffer = 0;
+  buffersStale = true;
 } // GeometricSurfaceFaceDS::GeometricSurfaceFaceDS()
 
 // read routine returns true on success, failure otherwise
@@ -56,11 +63,10 @@ bool GeometricSurfaceFaceDS::ReadFileTriangleSoup(
   Cartesian3 maxCoords(-1000000.0, -1000000.0, -1000000.0);
 
   // open the input file
-  // std::ifstream inFile(fileName);
   std::filesystem::path filePath(fileName);
-  std::ifstream inFile(filePath, std::ios::in);
+  MappedFile inFile(filePath);
 
-  if (inFile.bad())
+  if (!inFile.isOpen())
     return false;
 
   // set the number of vertices and faces
@@ -76,61 +82,47 @@ bool GeometricSurfaceFaceDS::ReadFileTriangleSoup(
   // extension for diredge rendering, otherwise we can just do the .tri like
   // usual
   if (fileType.compare(".diredge") == 0) {
-	std::string strLine;
-	std::vector<Vertex> vertexInput;
-	std::vector<Face> faceInput;
-
-	std::string inputType;
-	float i1, i2, i3;
-	int id;
-
-	// read in the file and store its data
-	while(std::getline(inFile, strLine)){
-	  // skip comment boilerplate and empty lines
-      if (strLine[0] == '#')
-        continue;
-
-	  std::stringstream ss(strLine);
-      ss >> inputType >> id >> i1 >> i2 >> i3;
-
-	  // we only need to read the vertices and faces here
-	  if (inputType.compare("Vertex") == 0) {
-
-		// std::cout << "V: " << id << " | " << i1 << " " << i2 << " " << i3 << std::endl;
-        vertexInput.push_back(Vertex(id, i1, i2, i3));
-
-		// we can also set the min and max coords here for the bounding box
-		if(i1 < minCoords.x) minCoords.x = i1;
-		if(i2 < minCoords.y) minCoords.y = i2;
-		if(i3 < minCoords.z) minCoords.z = i3;
-
-		if(i1 > maxCoords.x) maxCoords.x = i1;
-		if(i2 > maxCoords.y) maxCoords.y = i2;
-		if(i3 > maxCoords.z) maxCoords.z = i3;
-
-	  } // for each vertex
-      else if (inputType.compare("Face") == 0) {
-        faceInput.push_back(Face(id, (std::vector<int>){(int)i1, (int)i2, (int)i3}));
-	  }
-	}
+	DirectedEdgeMesh mesh;
+	std::string error;
 
-	// store the vertices of the mesh with the faces
-	for(auto f : faceInput){
-	  for(int i : f.vertexIDs){
-		Cartesian3 currentVertex = vertexInput[i].point;
+	// read in the file and store its data (text or binary)
+	if (!readMeshRecords(filePath, mesh, error)) {
+	  std::cout << error << std::endl;
+	  return false;
+	}
 
-		vertices.push_back(currentVertex);
-		midPoint = midPoint + currentVertex;
-	  }
+	// we can also set the min and max coords here for the bounding box
+	for (int v = 0; v < mesh.vertexCount(); v++) {
+	  Cartesian3 p = mesh.position(v);
+	  if(p.x < minCoords.x) minCoords.x = p.x;
+	  if(p.y < minCoords.y) minCoords.y = p.y;
+	  if(p.z < minCoords.z) minCoords.z = p.z;
+
+	  if(p.x > maxCoords.x) maxCoords.x = p.x;
+	  if(p.y > maxCoords.y) maxCoords.y = p.y;
+	  if(p.z > maxCoords.z) maxCoords.z = p.z;
+	} // for each vertex
+
+	// store the vertices of the mesh with the faces, the loader has checked
+	// that every face vertex exists
+	vertices.resize(mesh.edgeCount());
+	for(int e = 0; e < mesh.edgeCount(); e++){
+	  vertices[e] = mesh.position(mesh.to(e));
+	  midPoint = midPoint + vertices[e];
 	}
 
-	nVertices = faceInput.size() * 3;
+	nVertices = vertices.size();
 	midPoint = midPoint / vertices.size();
   }
   // otherwise, treat it like a .tri file
   else {
+    TextScanner scanner(inFile.begin(), inFile.end());
+
     // read in the number of vertices
-    inFile >> nTriangles;
+    int count = 0;
+    if (!scanner.readInt(count) || count < 0)
+      return false;
+    nTriangles = count;
     nVertices = nTriangles * 3;
 
     // now allocate space for them all
@@ -138,7 +130,14 @@ bool GeometricSurfaceFaceDS::ReadFileTriangleSoup(
 
     // now loop to read the vertices in, and hope nothing goes wrong
     for (int vertex = 0; vertex < nVertices; vertex++) { // for each vertex
-      inFile >> vertices[vertex].x >> vertices[vertex].y >> vertices[vertex].z;
+      if (!scanner.readFloat(vertices[vertex].x) ||
+          !scanner.readFloat(vertices[vertex].y) ||
+          !scanner.readFloat(vertices[vertex].z)) {
+        // keep the complete triangles of a truncated file
+        nVertices = vertex - vertex % 3;
+        vertices.resize(nVertices);
+        break;
+      }
 
       // keep running track of midpoint, &c.
       midPoint = midPoint + vertices[vertex];
@@ -173,29 +172,125 @@ bool GeometricSurfaceFaceDS::ReadFileTriangleSoup(
   // the bounding sphere radius is just half the distance between these
   boundingSphereSize = sqrt((maxCoords - minCoords).length()) * 1.0;
 
+  Changed();
   return true;
 } // GeometricSurfaceFaceDS::ReadFileTriangleSoup()
 
-// routine to render
-void GeometricSurfaceFaceDS::Render() { // GeometricSurfaceFaceDS::Render()
-  // walk through the faces rendering each one
-  glBegin(GL_TRIANGLES);
-
-  // we will loop in 3's, assuming CCW order
-  for (unsigned int vertex = 0; vertex < vertices.size();) { // per triangle
-    // use increment to step through them
-    Cartesian3 *v0 = &(vertices[vertex++]);
-    Cartesian3 *v1 = &(vertices[vertex++]);
-    Cartesian3 *v2 = &(vertices[vertex++]);
-    // now compute the normal vector
-    Cartesian3 uVec = *v1 - *v0;
-    Cartesian3 vVec = *v2 - *v0;
+// call after changing the vertices, so that the next render uploads them
+void GeometricSurfaceFaceDS::Changed() { // GeometricSurfaceFaceDS::Changed()
+  ComputeNormals();
+  buffersStale = true;
+} // GeometricSurfaceFaceDS::Changed()
+
+// routine to compute the normal of every triangle
+// each normal is (v1 - v0) x (v2 - v0), normalised, stored at all three of
+// the triangle's vertices, the vector path does the same float operations in
+// the same order as Cartesian3, so both give the same bits
+void GeometricSurfaceFaceDS::
+    ComputeNormals() { // GeometricSurfaceFaceDS::ComputeNormals()
+  normals.resize(vertices.size());
+  size_t nTriangles = vertices.size() / 3;
+  size_t triangle = 0;
+
+#ifdef __SSE__
+  // four triangles at a time, one register per coordinate of each corner
+  for (; triangle + 4 <= nTriangles; triangle += 4) { // per four triangles
+    // gather the corners into [corner][coordinate][triangle]
+    alignas(16) float corners[3][3][4];
+    for (int t = 0; t < 4; t++)
+      for (int c = 0; c < 3; c++) {
+        const Cartesian3 &p = vertices[3 * (triangle + t) + c];
+        corners[c][0][t] = p.x;
+        corners[c][1][t] = p.y;
+        corners[c][2][t] = p.z;
+      }
+
+    __m128 u[3], v[3];
+    for (int k = 0; k < 3; k++) {
+      __m128 p0 = _mm_load_ps(corners[0][k]);
+      u[k] = _mm_sub_ps(_mm_load_ps(corners[1][k]), p0);
+      v[k] = _mm_sub_ps(_mm_load_ps(corners[2][k]), p0);
+    }
+
+    // the cross product and its length
+    __m128 n[3];
+    n[0] = _mm_sub_ps(_mm_mul_ps(u[1], v[2]), _mm_mul_ps(u[2], v[1]));
+    n[1] = _mm_sub_ps(_mm_mul_ps(u[2], v[0]), _mm_mul_ps(u[0], v[2]));
+    n[2] = _mm_sub_ps(_mm_mul_ps(u[0], v[1]), _mm_mul_ps(u[1], v[0]));
+    __m128 length = _mm_sqrt_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(n[0], n[0]), _mm_mul_ps(n[1], n[1])),
+                   _mm_mul_ps(n[2], n[2])));
+
+    alignas(16) float unit[3][4];
+    for (int k = 0; k < 3; k++)
+      _mm_store_ps(unit[k], _mm_div_ps(n[k], length));
+
+    // scatter each normal to the triangle's three vertices
+    for (int t = 0; t < 4; t++) {
+      Cartesian3 normal(unit[0][t], unit[1][t], unit[2][t]);
+      for (int c = 0; c < 3; c++)
+        normals[3 * (triangle + t) + c] = normal;
+    }
+  } // per four triangles
+#endif
+
+  // the rest one at a time
+  for (; triangle < nTriangles; triangle++) { // per triangle
+    size_t vertex = 3 * triangle;
+    Cartesian3 uVec = vertices[vertex + 1] - vertices[vertex];
+    Cartesian3 vVec = vertices[vertex + 2] - vertices[vertex];
     Cartesian3 normal = uVec.cross(vVec).normalise();
 
-    glNormal3fv(&normal.x);
-    glVertex3fv(&v0->x);
-    glVertex3fv(&v1->x);
-    glVertex3fv(&v2->x);
+    normals[vertex] = normals[vertex + 1] = normals[vertex + 2] = normal;
   } // per triangle
-  glEnd();
+} // GeometricSurfaceFaceDS::ComputeNormals()
+
+// routine to render
+void GeometricSurfaceFaceDS::Render() { // GeometricSurfaceFaceDS::Render()
+  // upload the vertices and normals the first time, and after a change
+  // the normals were computed when the vertices changed
+  if (buffersStale) { // upload
+    if (vertexBuffer == 0)
+      glGenBuffers(1, &vertexBuffer);
+    if (normalBuffer == 0)
+      glGenBuffers(1, &normalBuffer);
+
+    // Cartesian3 is three packed floats, so the arrays go up as they are
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Cartesian3),
+                 vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, normalBuffer);
+    glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(Cartesian3),
+                 normals.data(), GL_STATIC_DRAW);
+
+    buffersStale = false;
+  } // upload
+
+  // draw every triangle from the buffers in one call
+  glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(3, GL_FLOAT, sizeof(Cartesian3), nullptr);
+
+  glBindBuffer(GL_ARRAY_BUFFER, normalBuffer);
+  glEnableClientState(GL_NORMAL_ARRAY);
+  glNormalPointer(GL_FLOAT, sizeof(Cartesian3), nullptr);
+
+  glDrawArrays(GL_TRIANGLES, 0, vertices.size());
+
+  glDisableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 } // GeometricSurfaceFaceDS::Render()
+
+// delete the vertex buffer objects
+void GeometricSurfaceFaceDS::
+    ReleaseBuffers() { // GeometricSurfaceFaceDS::ReleaseBuffers()
+  if (vertexBuffer != 0)
+    glDeleteBuffers(1, &vertexBuffer);
+  if (normalBuffer != 0)
+    glDeleteBuffers(1, &normalBuffer);
+
+  // a later render creates them again
+  vertexBuffer = normalBuffer = 0;
+  buffersStale = true;
+} // GeometricSurfaceFaceDS::ReleaseBuffers()
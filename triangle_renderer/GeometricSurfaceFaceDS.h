@@ -29,6 +29,17 @@ class GeometricSurfaceFaceDS
 	// vectors to store vertex and triangle information - relying on POD rule
 	std::vector<Cartesian3> vertices;
 
+	// normal of each triangle, repeated at its three vertices so that it can
+	// go to the GPU alongside them
+	std::vector<Cartesian3> normals;
+
+	// vertex buffer objects for the vertices and normals, 0 until the first
+	// render creates them
+	unsigned int vertexBuffer, normalBuffer;
+
+	// true when the vertices have changed since they were last uploaded
+	bool buffersStale;
+
 	// bounding sphere size
 	float boundingSphereSize;
 
@@ -41,8 +52,19 @@ class GeometricSurfaceFaceDS
 	// read routine returns true on success, failure otherwise
 	bool ReadFileTriangleSoup(char *fileName);
 	
+	// call after changing the vertices, recomputes the normals so that the
+	// next render uploads both
+	void Changed();
+
+	// routine to compute the normal of every triangle into normals
+	void ComputeNormals();
+
 	// routine to render
 	void Render();
+
+	// delete the vertex buffer objects, the GL context that rendered the
+	// surface must be current
+	void ReleaseBuffers();
 	}; // class GeometricSurfaceFaceDS
 
 #endif
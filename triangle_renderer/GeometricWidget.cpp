@@ -45,7 +45,10 @@ GeometricWidget::GeometricWidget(GeometricSurfaceFaceDS *newSurface, QWidget *pa
 // destructor
 GeometricWidget::~GeometricWidget()
 	{ // destructor
-	// nothing yet
+	// the surface's buffers belong to this widget's context
+	makeCurrent();
+	surface->ReleaseBuffers();
+	doneCurrent();
 	} // destructor																	
 
 // called when OpenGL context is set up
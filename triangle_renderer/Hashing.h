@@ -0,0 +1,35 @@
+#ifndef HASHING_H
+#define HASHING_H
+
+#include <cstdint>
+#include <cstring>
+
+// finaliser from splitmix64, spreads the key bits across the whole word so
+// that the low bits can be used directly as a table index
+inline uint64_t mixBits(uint64_t key) {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+  return key;
+}
+
+// bit pattern of a coordinate, with -0.0 folded onto 0.0 so that the key
+// agrees with float equality
+inline uint32_t floatBits(float value) {
+  uint32_t bits;
+  value += 0.0f;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// smallest power of two table size that keeps the load factor at most 1/2
+inline size_t tableSizeFor(size_t expectedKeys) {
+  size_t size = 16;
+  while (size < expectedKeys * 2)
+    size <<= 1;
+  return size;
+}
+
+#endif
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "HoleRefinement.h"
+#include "MeshGeometry.h"
+
+namespace {
+
+// refinement stops after this many rounds of splits, and each round after
+// this many passes of flips, should the flips not settle
+const int MAX_ROUNDS = 64;
+const int MAX_RELAX_PASSES = 64;
+
+const float PI = 3.14159265f;
+
+// the angle at corner b of the triangle a b c
+float cornerAngle(Cartesian3 a, Cartesian3 b, Cartesian3 c) {
+  Cartesian3 u = a - b, v = c - b;
+  Cartesian3 normal = u.cross(v);
+  return std::atan2(vectorLength(normal), dot(u, v));
+}
+
+// an undirected edge as one key, the same for u -> v and v -> u
+uint64_t undirectedKey(int u, int v) {
+  return (uint64_t)std::min(u, v) << 32 | (uint32_t)std::max(u, v);
+}
+
+// the directed edges leaving v, from the fan of its first directed edge and
+// the fans of the given edges, each fan once, so that a vertex where several
+// fans meet, as on a rim that a hole passed through twice, is seen whole
+void outgoingEdges(const DirectedEdgeMesh &mesh, int v,
+                   const std::vector<int> &starts, std::vector<int> &edges) {
+  edges.clear();
+  if (mesh.firstDirectedEdges[v] != -1)
+    mesh.fanEdges(mesh.firstDirectedEdges[v], edges);
+
+  for (int start : starts)
+    if (std::find(edges.begin(), edges.end(), start) == edges.end())
+      mesh.fanEdges(start, edges);
+}
+
+class PatchRefiner
+{
+ public:
+  // everything is found from the patch's faces and the one-rings of its
+  // vertices, so the set-up grows with the patch and not with the mesh
+  PatchRefiner(DirectedEdgeMesh &mesh, int firstFace, float density)
+      : mesh(mesh), firstFace(firstFace), density(density) {
+    // the patch's vertices, each with its edges in the patch
+    std::vector<int> vertices;
+    std::unordered_map<int, std::vector<int>> patchEdges;
+    for (int e = 3 * firstFace; e < mesh.edgeCount(); e++) {
+      std::vector<int> &leaving = patchEdges[mesh.from(e)];
+      if (leaving.empty())
+        vertices.push_back(mesh.from(e));
+      leaving.push_back(e);
+    }
+
+    // the edges between patch vertices, so that a flip never doubles one,
+    // and the scale of the rim from the edges outside the patch, each edge
+    // once from each end when both of its faces are outside
+    std::unordered_map<int, int> counts;
+    std::vector<int> ring;
+    for (int v : vertices) {
+      float sum = 0.0f;
+      int count = 0;
+      outgoingEdges(mesh, v, patchEdges[v], ring);
+      for (int e : ring) {
+        int u = mesh.to(e);
+        if (patchEdges.count(u))
+          edges.insert(undirectedKey(v, u));
+        if (DirectedEdgeMesh::face(e) < firstFace) {
+          sum += distance(mesh.position(v), mesh.position(u));
+          count++;
+        }
+      }
+      scale[v] = count > 0 ? sum / count : 0.0f;
+      counts[v] = count;
+    }
+
+    // vertices added inside a fill, e.g. a fan's centre, only have patch
+    // edges, and take the scale of their neighbours on the rim
+    for (int v : vertices) {
+      if (counts[v] > 0)
+        continue;
+
+      float sum = 0.0f;
+      int neighbours = 0;
+      for (int e : patchEdges[v]) {
+        int u = mesh.to(e);
+        if (counts[u] > 0) {
+          sum += scale[u];
+          neighbours++;
+        }
+      }
+      if (neighbours > 0)
+        scale[v] = sum / neighbours;
+    }
+  }
+
+  int refine() {
+    int added = 0;
+    for (int round = 0; round < MAX_ROUNDS; round++) {
+      // faces split in this round are looked at again in the next
+      int faces = mesh.faceCount();
+      int splits = 0;
+      for (int f = firstFace; f < faces; f++)
+        splits += splitFace(f);
+
+      if (splits == 0)
+        break;
+      added += splits;
+
+      for (int pass = 0; pass < MAX_RELAX_PASSES; pass++) {
+        bool flipped = false;
+        for (int e = 3 * firstFace; e < mesh.edgeCount(); e++)
+          if (e < mesh.otherHalves[e] && relax(e))
+            flipped = true;
+        if (!flipped)
+          break;
+      }
+    }
+    return added;
+  }
+
+ private:
+  DirectedEdgeMesh &mesh;
+  int firstFace;
+  float density;
+  std::unordered_map<int, float> scale;
+  std::unordered_set<uint64_t> edges;
+
+  void pair(int e, int twin) {
+    mesh.otherHalves[e] = twin;
+    if (twin != -1)
+      mesh.otherHalves[twin] = e;
+  }
+
+  // split face f into three around a new vertex at its centroid, if the face
+  // is large against the scale around it
+  bool splitFace(int f) {
+    int v0 = mesh.faceVertices[3 * f], v1 = mesh.faceVertices[3 * f + 1],
+        v2 = mesh.faceVertices[3 * f + 2];
+    Cartesian3 p0 = mesh.position(v0), p1 = mesh.position(v1),
+               p2 = mesh.position(v2);
+    Cartesian3 centroid = (p0 + p1 + p2) / 3.0f;
+    float centroidScale = (scale[v0] + scale[v1] + scale[v2]) / 3.0f;
+
+    for (int v : {v0, v1, v2}) {
+      float reach = density * distance(centroid, mesh.position(v));
+      if (!(reach > centroidScale && reach > scale[v]))
+        return false;
+    }
+
+    // face f keeps v0 -> v1, the new faces take v1 -> v2 and v2 -> v0
+    int twin12 = mesh.otherHalves[3 * f + 2];
+    int twin20 = mesh.otherHalves[3 * f];
+
+    int c = mesh.addVertex(centroid);
+    scale[c] = centroidScale;
+
+    mesh.setFace(f, v0, v1, c);
+    int f1 = mesh.addFace(v1, v2, c);
+    int f2 = mesh.addFace(v2, v0, c);
+
+    pair(3 * f1 + 1, twin12);
+    pair(3 * f2 + 1, twin20);
+    pair(3 * f + 2, 3 * f1);
+    pair(3 * f1 + 2, 3 * f2);
+    pair(3 * f2 + 2, 3 * f);
+
+    mesh.firstDirectedEdges[c] = 3 * f;
+    mesh.firstDirectedEdges[v0] = 3 * f + 1;
+    mesh.firstDirectedEdges[v1] = 3 * f1 + 1;
+    mesh.firstDirectedEdges[v2] = 3 * f2 + 1;
+
+    for (int v : {v0, v1, v2})
+      edges.insert(undirectedKey(c, v));
+
+    // the old edges may no longer suit the smaller faces
+    relax(3 * f + 1);
+    relax(3 * f1 + 1);
+    relax(3 * f2 + 1);
+    return true;
+  }
+
+  // flip edge e, a -> b between the faces a b c and b a d, to c -> d if both
+  // faces are in the patch and the flip improves them
+  bool relax(int e) {
+    int twin = mesh.otherHalves[e];
+    if (twin == -1 || DirectedEdgeMesh::face(e) < firstFace ||
+        DirectedEdgeMesh::face(twin) < firstFace)
+      return false;
+
+    int a = mesh.from(e), b = mesh.to(e);
+    int c = mesh.to(DirectedEdgeMesh::next(e));
+    int d = mesh.to(DirectedEdgeMesh::next(twin));
+    if (c == d || edges.count(undirectedKey(c, d)))
+      return false;
+
+    Cartesian3 pa = mesh.position(a), pb = mesh.position(b),
+               pc = mesh.position(c), pd = mesh.position(d);
+
+    float opposite = cornerAngle(pa, pc, pb) + cornerAngle(pb, pd, pa);
+    float flippedOpposite = cornerAngle(pc, pa, pd) + cornerAngle(pd, pb, pc);
+    if (opposite <= PI + 1e-5f || flippedOpposite >= opposite)
+      return false;
+
+    // the new faces must face the same way, or the quad was not convex
+    if (dot(triangleNormal(pa, pd, pc), triangleNormal(pb, pc, pd)) <= 0.0f)
+      return false;
+
+    int f = DirectedEdgeMesh::face(e), g = DirectedEdgeMesh::face(twin);
+    int twinBC = mesh.otherHalves[DirectedEdgeMesh::next(e)];
+    int twinCA = mesh.otherHalves[DirectedEdgeMesh::prev(e)];
+    int twinAD = mesh.otherHalves[DirectedEdgeMesh::next(twin)];
+    int twinDB = mesh.otherHalves[DirectedEdgeMesh::prev(twin)];
+
+    // the faces become a d c and b c d
+    mesh.setFace(f, a, d, c);
+    mesh.setFace(g, b, c, d);
+
+    pair(3 * f, twinCA);
+    pair(3 * f + 1, twinAD);
+    pair(3 * g, twinDB);
+    pair(3 * g + 1, twinBC);
+    pair(3 * f + 2, 3 * g + 2);
+
+    mesh.firstDirectedEdges[a] = 3 * f + 1;
+    mesh.firstDirectedEdges[b] = 3 * g + 1;
+    mesh.firstDirectedEdges[c] = 3 * g + 2;
+    mesh.firstDirectedEdges[d] = 3 * f + 2;
+
+    edges.erase(undirectedKey(a, b));
+    edges.insert(undirectedKey(c, d));
+    return true;
+  }
+};
+
+} // namespace
+
+int refinePatch(DirectedEdgeMesh &mesh, int firstFace, float density) {
+  if (firstFace >= mesh.faceCount())
+    return 0;
+  return PatchRefiner(mesh, firstFace, density).refine();
+}
@@ -0,0 +1,30 @@
+#ifndef HOLE_REFINEMENT_H
+#define HOLE_REFINEMENT_H
+
+#include "DirectedEdgeMesh.h"
+
+// how finely a patch is refined, larger values give more, smaller faces
+const float PATCH_DENSITY = 1.41421356f;
+
+// refine the patch of faces from firstFace to the end of the mesh, the faces
+// filled into its holes, so that its vertices are about as dense as those of
+// the mesh around it, as in Liepa, "Filling Holes in Meshes" (2003):
+//   - each vertex of the patch's rim has a scale, the mean length of its
+//     edges outside the patch, a vertex inside a fill has the mean scale of
+//     its rim neighbours, and a vertex added by a split the mean scale of the
+//     face it splits
+//   - a face is split into three at its centroid c when, for each of its
+//     corners m, density * |c - m| is larger than the scales of both c and m
+//   - after each round of splits, edges inside the patch are flipped while
+//     the angles opposite them sum to more than pi and flipping makes the sum
+//     smaller without folding the two faces over
+// until a round splits no face
+//
+// every edge of the patch must be paired, as it is once the holes are filled
+// edges between the patch and the mesh are never flipped, so only the inside
+// of the patch changes, and new vertices and faces are appended
+// returns the number of vertices added
+int refinePatch(DirectedEdgeMesh &mesh, int firstFace,
+                float density = PATCH_DENSITY);
+
+#endif
@@ -0,0 +1,215 @@
+#include <algorithm>
+
+#include "HoleTriangulation.h"
+#include "MeshGeometry.h"
+
+namespace {
+
+// unit normal of a face, zero when it is degenerate
+Cartesian3 unitNormal(Cartesian3 normal) {
+  float length = vectorLength(normal);
+  return length > 0.0f ? normal / length : Cartesian3(0.0f, 0.0f, 0.0f);
+}
+
+// 1 - cos of the dihedral angle between two faces from their unit normals,
+// which orders the same as the angle without an acos, 0 when either face is
+// degenerate
+float bend(const Cartesian3 &n1, const Cartesian3 &n2) {
+  if (dot(n1, n1) == 0.0f || dot(n2, n2) == 0.0f)
+    return 0.0f;
+  return 1.0f - dot(n1, n2);
+}
+
+// the weight of a triangulation, compared lexicographically
+struct Weight {
+  int degenerate = 0;
+  // of the largest dihedral angle
+  float bend = 0.0f;
+  double area = 0.0;
+
+  bool operator<(const Weight &other) const {
+    if (degenerate != other.degenerate)
+      return degenerate < other.degenerate;
+    if (bend != other.bend)
+      return bend < other.bend;
+    return area < other.area;
+  }
+};
+
+Weight combine(const Weight &a, const Weight &b) {
+  return {a.degenerate + b.degenerate, std::max(a.bend, b.bend),
+          a.area + b.area};
+}
+
+class LoopTriangulator
+{
+ public:
+  LoopTriangulator(const DirectedEdgeMesh &mesh, const std::vector<int> &hole,
+                   int dpLimit)
+      : loopSize(hole.size()), dpLimit(std::max(dpLimit, 3)) {
+    for (int e : hole) {
+      vertices.push_back(mesh.to(e));
+      points.push_back(mesh.position(mesh.to(e)));
+
+      // the face on the far side of the rim edge is the existing face of e
+      int f = DirectedEdgeMesh::face(e);
+      rimNormals.push_back(unitNormal(
+          triangleNormal(mesh.position(mesh.faceVertices[3 * f]),
+                         mesh.position(mesh.faceVertices[3 * f + 1]),
+                         mesh.position(mesh.faceVertices[3 * f + 2]))));
+    }
+  }
+
+  // triangulate a polygon of loop positions, in loop order, whose last edge
+  // runs back to its first position
+  void triangulate(const std::vector<int> &polygon,
+                   std::vector<HoleTriangle> &triangles) {
+    int size = polygon.size();
+    if (size < 3)
+      return;
+
+    if (size <= dpLimit) {
+      minimumWeight(polygon, triangles);
+      return;
+    }
+
+    // split at the shortest chord between positions half way round, so both
+    // parts are about half the size, skipping chords between copies of one
+    // vertex
+    // compared by squared length, which orders the same
+    int bestStart = -1;
+    float bestLength = 0.0f;
+    for (int s = 0; s + size / 2 < size; s++) {
+      int t = s + size / 2;
+      if (vertices[polygon[s]] == vertices[polygon[t]])
+        continue;
+
+      Cartesian3 chord = points[polygon[t]] - points[polygon[s]];
+      float length = dot(chord, chord);
+      if (bestStart == -1 || length < bestLength) {
+        bestStart = s;
+        bestLength = length;
+      }
+    }
+
+    if (bestStart == -1)
+      bestStart = 0;
+    int bestEnd = bestStart + size / 2;
+
+    std::vector<int> first(polygon.begin() + bestStart,
+                           polygon.begin() + bestEnd + 1);
+    std::vector<int> second(polygon.begin() + bestEnd, polygon.end());
+    second.insert(second.end(), polygon.begin(),
+                  polygon.begin() + bestStart + 1);
+
+    triangulate(first, triangles);
+    triangulate(second, triangles);
+  }
+
+ private:
+  int loopSize;
+  int dpLimit;
+  std::vector<int> vertices;
+  std::vector<Cartesian3> points;
+  std::vector<Cartesian3> rimNormals;
+
+  // unit normal of the existing face across the edge from position a to b,
+  // if it is a rim edge of the hole rather than a chord
+  bool rimNormal(int a, int b, Cartesian3 &across) {
+    if (b != (a + 1) % loopSize)
+      return false;
+
+    across = rimNormals[a];
+    return true;
+  }
+
+  // the dynamic programme over a polygon: best[i][k] is the least weight of
+  // the part of the polygon from i to k closed by the chord k -> i, apex the
+  // third vertex of the face on that chord and chordNormal its unit normal
+  void minimumWeight(const std::vector<int> &polygon,
+                     std::vector<HoleTriangle> &triangles) {
+    int size = polygon.size();
+    std::vector<Weight> best(size * size);
+    std::vector<int> apex(size * size, -1);
+    std::vector<Cartesian3> chordNormal(size * size);
+
+    // normal of the face on the chord from i to k, or of the existing face
+    // when i and k are neighbours on the rim
+    auto neighbourNormal = [&](int i, int k, Cartesian3 &across) {
+      if (k == i + 1)
+        return rimNormal(polygon[i], polygon[k], across);
+
+      across = chordNormal[i * size + k];
+      return true;
+    };
+
+    for (int gap = 2; gap < size; gap++) {
+      for (int i = 0; i + gap < size; i++) {
+        int k = i + gap;
+
+        for (int m = i + 1; m < k; m++) {
+          Weight weight = combine(best[i * size + m], best[m * size + k]);
+
+          Cartesian3 faceNormal = triangleNormal(
+              points[polygon[i]], points[polygon[m]], points[polygon[k]]);
+          float area = 0.5f * vectorLength(faceNormal);
+          faceNormal = unitNormal(faceNormal);
+          weight.area += area;
+          if (area == 0.0f || vertices[polygon[i]] == vertices[polygon[m]] ||
+              vertices[polygon[m]] == vertices[polygon[k]] ||
+              vertices[polygon[k]] == vertices[polygon[i]])
+            weight.degenerate++;
+
+          Cartesian3 across;
+          if (neighbourNormal(i, m, across))
+            weight.bend = std::max(weight.bend, bend(faceNormal, across));
+          if (neighbourNormal(m, k, across))
+            weight.bend = std::max(weight.bend, bend(faceNormal, across));
+
+          // the last face also meets the polygon's closing edge
+          if (i == 0 && k == size - 1 &&
+              rimNormal(polygon[k], polygon[i], across))
+            weight.bend = std::max(weight.bend, bend(faceNormal, across));
+
+          if (apex[i * size + k] == -1 || weight < best[i * size + k]) {
+            best[i * size + k] = weight;
+            apex[i * size + k] = m;
+            chordNormal[i * size + k] = faceNormal;
+          }
+        }
+      }
+    }
+
+    // read the faces back from the closing chord inwards
+    std::vector<std::pair<int, int>> chords = {{0, size - 1}};
+    while (!chords.empty()) {
+      auto [i, k] = chords.back();
+      chords.pop_back();
+      if (k - i < 2)
+        continue;
+
+      int m = apex[i * size + k];
+      triangles.push_back({polygon[i], polygon[m], polygon[k]});
+      chords.push_back({i, m});
+      chords.push_back({m, k});
+    }
+  }
+};
+
+} // namespace
+
+std::vector<HoleTriangle>
+minimumWeightTriangulation(const DirectedEdgeMesh &mesh,
+                           const std::vector<int> &hole, int dpLimit) {
+  std::vector<HoleTriangle> triangles;
+  if (hole.size() < 3)
+    return triangles;
+
+  std::vector<int> polygon(hole.size());
+  for (size_t i = 0; i < polygon.size(); i++)
+    polygon[i] = i;
+
+  triangles.reserve(hole.size() - 2);
+  LoopTriangulator(mesh, hole, dpLimit).triangulate(polygon, triangles);
+  return triangles;
+}
@@ -0,0 +1,45 @@
+#ifndef HOLE_TRIANGULATION_H
+#define HOLE_TRIANGULATION_H
+
+#include <vector>
+
+#include "DirectedEdgeMesh.h"
+
+// a hole is the list of its boundary edges in the order meshRepair traces
+// them, backwards around the hole, so each edge ends where the one before it
+// starts: to(hole[i + 1]) == from(hole[i])
+//
+// position i of the hole's loop is the vertex to(hole[i]), and a face over
+// the hole closes hole[i] with an edge from position i to position i + 1
+
+// a new face over a hole, as positions in its loop, in the order its vertices
+// are stored, so it has the edges c -> a, a -> b and b -> c
+struct HoleTriangle {
+  int a, b, c;
+};
+
+// holes of more loop positions than this are split in two along a short
+// chord until each part is small enough for the dynamic programme
+const int MINIMUM_WEIGHT_DP_LIMIT = 96;
+
+// triangulate a hole of at least three edges with no new vertices, choosing
+// the triangulation of least weight by dynamic programming over the loop
+//
+// the weight of a triangulation compares, in order:
+//   - the number of degenerate faces (a repeated vertex or zero area)
+//   - the largest dihedral angle between neighbouring faces, new or old
+//   - the total area
+// so the patch follows the surface around the hole before it is made small
+//
+// a loop of n positions takes O(n^3) time and O(n^2) memory up to dpLimit,
+// larger loops are split recursively, which keeps holes of thousands of
+// edges to O(n dpLimit^2), the triangulation is then only optimal within
+// each part
+//
+// returns n - 2 faces
+std::vector<HoleTriangle>
+minimumWeightTriangulation(const DirectedEdgeMesh &mesh,
+                           const std::vector<int> &hole,
+                           int dpLimit = MINIMUM_WEIGHT_DP_LIMIT);
+
+#endif
@@ -0,0 +1,162 @@
+#include <atomic>
+
+#include "Bitset.h"
+#include "MeshComponents.h"
+#include "Parallel.h"
+
+namespace {
+
+// the root of a face's set, halving the path on the way
+int findRoot(std::vector<std::atomic<int>> &parent, int face) {
+  for (;;) {
+    int up = parent[face].load(std::memory_order_relaxed);
+    if (up == face)
+      return face;
+
+    int upper = parent[up].load(std::memory_order_relaxed);
+    if (upper != up)
+      parent[face].compare_exchange_weak(up, upper, std::memory_order_relaxed);
+    face = upper;
+  }
+}
+
+// the larger root always goes under the smaller one, so every root is the
+// lowest face of its set whatever order the threads link in
+void unite(std::vector<std::atomic<int>> &parent, int a, int b) {
+  for (;;) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a == b)
+      return;
+    if (a < b)
+      std::swap(a, b);
+
+    int expected = a;
+    if (parent[a].compare_exchange_strong(expected, b,
+                                          std::memory_order_relaxed))
+      return;
+  }
+}
+
+// the boundary edge that follows edge in its loop: rotate around the vertex
+// edge points to until an edge leaving it has no other half
+// returns -1 if the rotation leaves the vertex, through other halves that do
+// not agree, or does not find one within the vertex's degree, so that broken
+// input costs no more than a walk round each fan
+int nextBoundaryEdge(const MeshView &mesh, const std::vector<int> &degrees,
+                     int edge) {
+  int v = mesh.to(edge);
+  int leaving = MeshView::next(edge);
+  for (int steps = 0; steps < degrees[v]; steps++) {
+    if (mesh.from(leaving) != v)
+      return -1;
+
+    int twin = mesh.otherHalves[leaving];
+    if (twin == -1)
+      return leaving;
+    leaving = MeshView::next(twin);
+  }
+  return -1;
+}
+
+} // namespace
+
+MeshComponents findComponents(MeshView mesh) {
+  int faces = mesh.faceCount();
+  MeshComponents result;
+
+  // PASS 1: union the two faces of every pair of other halves
+  std::vector<std::atomic<int>> parent(faces);
+  parallelFor(faces, [&](size_t begin, size_t end, int) {
+    for (size_t f = begin; f < end; f++)
+      parent[f].store(f, std::memory_order_relaxed);
+  });
+
+  parallelFor(mesh.edgeCount(), [&](size_t begin, size_t end, int) {
+    for (size_t e = begin; e < end; e++) {
+      int twin = mesh.otherHalves[e];
+      if (twin != -1 && (int)e < twin)
+        unite(parent, MeshView::face(e), MeshView::face(twin));
+    }
+  });
+
+  // PASS 2: number the roots in face order, each chunk counts its roots so
+  // that the numbering can be found with a prefix sum
+  std::vector<int> chunkRoots(parallelChunks(faces) + 1, 0);
+  parallelFor(faces, [&](size_t begin, size_t end, int chunk) {
+    for (size_t f = begin; f < end; f++)
+      chunkRoots[chunk + 1] += findRoot(parent, f) == (int)f;
+  });
+
+  for (size_t c = 1; c < chunkRoots.size(); c++)
+    chunkRoots[c] += chunkRoots[c - 1];
+
+  result.components.resize(chunkRoots.back());
+  result.componentOfFace.resize(faces);
+
+  parallelFor(faces, [&](size_t begin, size_t end, int chunk) {
+    int next = chunkRoots[chunk];
+    for (size_t f = begin; f < end; f++) {
+      if (findRoot(parent, f) == (int)f) {
+        result.components[next].firstFace = f;
+        result.componentOfFace[f] = next++;
+      }
+    }
+  });
+
+  // each face takes the number given to its root
+  parallelFor(faces, [&](size_t begin, size_t end, int) {
+    for (size_t f = begin; f < end; f++) {
+      int root = findRoot(parent, f);
+      if (root != (int)f)
+        result.componentOfFace[f] = result.componentOfFace[root];
+    }
+  });
+
+  // PASS 3: count faces and edges, a pair of other halves is counted at its
+  // lower edge
+  for (int e = 0; e < mesh.edgeCount(); e++) {
+    MeshComponent &component =
+        result.components[result.componentOfFace[MeshView::face(e)]];
+    int twin = mesh.otherHalves[e];
+    component.faces += e % 3 == 0;
+    component.edges += twin == -1 || e < twin;
+  }
+
+  // vertices: sort the (component, vertex) pair of every corner and count
+  // the distinct pairs
+  std::vector<KeyIndex> corners(mesh.edgeCount());
+  parallelFor(mesh.edgeCount(), [&](size_t begin, size_t end, int) {
+    for (size_t e = begin; e < end; e++) {
+      uint64_t component = result.componentOfFace[MeshView::face(e)];
+      corners[e] = {(component << 32) | (uint32_t)mesh.to(e), 0};
+    }
+  });
+  parallelRadixSort(corners);
+
+  for (size_t i = 0; i < corners.size(); i++)
+    if (i == 0 || corners[i].key != corners[i - 1].key)
+      result.components[corners[i].key >> 32].vertices++;
+
+  // boundary loops: follow each unvisited boundary edge round its loop
+  std::vector<int> degrees = mesh.vertexDegrees();
+  Bitset visited(mesh.edgeCount());
+  for (int e = 0; e < mesh.edgeCount(); e++) {
+    if (mesh.otherHalves[e] != -1 || visited.test(e))
+      continue;
+
+    result.components[result.componentOfFace[MeshView::face(e)]].boundaryLoops++;
+    for (int edge = e; edge != -1 && !visited.test(edge);
+         edge = nextBoundaryEdge(mesh, degrees, edge))
+      visited.set(edge);
+  }
+
+  for (auto &component : result.components) {
+    component.eulerCharacteristic =
+        component.vertices - component.edges + component.faces;
+    component.genus =
+        (2 - component.boundaryLoops - component.eulerCharacteristic) / 2;
+  }
+
+  return result;
+}
@@ -0,0 +1,45 @@
+#ifndef MESH_COMPONENTS_H
+#define MESH_COMPONENTS_H
+
+#include <vector>
+
+#include "DirectedEdgeMesh.h"
+
+// one connected piece of a mesh, faces joined across their other halves
+struct MeshComponent {
+  // lowest face id in the component, components are listed in this order
+  int firstFace = 0;
+
+  int vertices = 0;
+  // undirected edges: each pair of other halves once, each boundary edge once
+  int edges = 0;
+  int faces = 0;
+  int boundaryLoops = 0;
+
+  // V - E + F
+  int eulerCharacteristic = 0;
+  // from V - E + F = 2 - 2g - b, only meaningful for a manifold component
+  int genus = 0;
+};
+
+// the components of a mesh and the component of each face
+struct MeshComponents {
+  std::vector<MeshComponent> components;
+  std::vector<int> componentOfFace;
+};
+
+// label the faces by a parallel union-find over the other halves and count
+// each component, all in integers
+//
+// a vertex shared by faces of several components (e.g. two shells touching at
+// a point) is counted once in each of them, vertices without faces are not
+// in any component
+//
+// boundary loops are counted by following each boundary edge to the next
+// boundary edge around its end vertex, so they need other halves that agree
+// with each other, where they do not a loop is cut short and counted in
+// pieces, and each step is bounded by the vertex's degree, so the count
+// stays O(E) for a mesh of bounded degree however broken it is
+MeshComponents findComponents(MeshView mesh);
+
+#endif
@@ -0,0 +1,167 @@
+#include "MeshDefects.h"
+#include "Parallel.h"
+
+namespace {
+
+// flag every id in [0, count) that isDefect picks
+// the ids are split into blocks of 64 so that every chunk owns whole words of
+// the bitset, and the chunks' examples are joined in order
+template <class Test>
+DefectList collectDefects(size_t count, int exampleLimit, const Test &isDefect) {
+  DefectList list;
+  list.flags = Bitset(count);
+
+  size_t blocks = (count + 63) / 64;
+  std::vector<DefectList> chunks(parallelChunks(blocks));
+
+  parallelFor(blocks, [&](size_t begin, size_t end, int chunk) {
+    DefectList &found = chunks[chunk];
+    for (size_t id = 64 * begin; id < std::min(64 * end, count); id++) {
+      if (!isDefect(id))
+        continue;
+
+      list.flags.set(id);
+      if (found.count++ < (size_t)exampleLimit)
+        found.examples.push_back(id);
+    }
+  });
+
+  for (auto &found : chunks) {
+    list.count += found.count;
+    for (int id : found.examples)
+      if (list.examples.size() < (size_t)exampleLimit)
+        list.examples.push_back(id);
+  }
+
+  return list;
+}
+
+// the number of faces in the fan around the vertex that start leaves, found
+// by rotating both ways from start until the fan closes or ends on a
+// boundary, -1 if the rotation meets an edge that cannot be followed
+int fanSize(const MeshView &mesh, const Bitset &badEdges, int start) {
+  auto usable = [&](int edge, int twin) {
+    return !badEdges.test(twin) && mesh.otherHalves[twin] == edge;
+  };
+
+  // the second rotation starts from start's other half
+  if (badEdges.test(start))
+    return -1;
+
+  int faces = 0;
+  int edge = start;
+  for (;;) {
+    faces++;
+    int incoming = MeshView::prev(edge);
+    if (badEdges.test(incoming) || faces > mesh.edgeCount())
+      return -1;
+
+    int twin = mesh.otherHalves[incoming];
+    if (twin == -1)
+      break;
+    if (!usable(incoming, twin))
+      return -1;
+
+    edge = twin;
+    if (edge == start)
+      return faces;
+  }
+
+  // the fan is open, so count the faces on the other side of start too
+  edge = start;
+  for (;;) {
+    int twin = mesh.otherHalves[edge];
+    if (twin == -1)
+      return faces;
+    if (!usable(edge, twin) || faces > mesh.edgeCount())
+      return -1;
+
+    edge = MeshView::next(twin);
+    if (badEdges.test(edge))
+      return -1;
+    faces++;
+  }
+}
+
+} // namespace
+
+bool MeshDefects::manifold() const {
+  return badIndices.count == 0 && badFirstEdges.count == 0 &&
+         boundaryEdges.count == 0 && twinMismatches.count == 0 &&
+         pinchVertices.count == 0;
+}
+
+void MeshDefects::dropFlags() {
+  for (DefectList *list : {&badIndices, &badFirstEdges, &boundaryEdges,
+                           &twinMismatches, &pinchVertices, &degenerateFaces})
+    list->flags = Bitset();
+}
+
+MeshDefects findDefects(MeshView mesh, int exampleLimit) {
+  MeshDefects defects;
+  int vertices = mesh.vertexCount();
+  int edges = mesh.edgeCount();
+
+  defects.badIndices = collectDefects(edges, exampleLimit, [&](int e) {
+    int vertex = mesh.faceVertices[e];
+    int twin = mesh.otherHalves[e];
+    return vertex < 0 || vertex >= vertices || twin < -1 || twin >= edges;
+  });
+  const Bitset &badEdges = defects.badIndices.flags;
+
+  defects.boundaryEdges = collectDefects(edges, exampleLimit, [&](int e) {
+    return !badEdges.test(e) && mesh.otherHalves[e] == -1;
+  });
+
+  defects.twinMismatches = collectDefects(edges, exampleLimit, [&](int e) {
+    int twin = mesh.otherHalves[e];
+    if (badEdges.test(e) || twin == -1)
+      return false;
+    return mesh.otherHalves[twin] != e || mesh.from(twin) != mesh.to(e) ||
+           mesh.to(twin) != mesh.from(e);
+  });
+
+  // corners at each vertex, counting only valid ids
+  std::vector<int> degrees(vertices, 0);
+  for (int e = 0; e < edges; e++)
+    if (mesh.faceVertices[e] >= 0 && mesh.faceVertices[e] < vertices)
+      degrees[mesh.faceVertices[e]]++;
+
+  defects.badFirstEdges = collectDefects(vertices, exampleLimit, [&](int v) {
+    int first = mesh.firstDirectedEdges[v];
+    if (first == -1)
+      return degrees[v] > 0;
+    return first < 0 || first >= edges || mesh.from(first) != v;
+  });
+  const Bitset &badFirst = defects.badFirstEdges.flags;
+
+  // a vertex whose fan cannot be walked is left out rather than guessed at
+  defects.pinchVertices = collectDefects(vertices, exampleLimit, [&](int v) {
+    int first = mesh.firstDirectedEdges[v];
+    if (first == -1 || badFirst.test(v))
+      return false;
+
+    int faces = fanSize(mesh, badEdges, first);
+    return faces != -1 && faces != degrees[v];
+  });
+
+  defects.degenerateFaces =
+      collectDefects(mesh.faceCount(), exampleLimit, [&](int f) {
+        int v0 = mesh.faceVertices[3 * f];
+        int v1 = mesh.faceVertices[3 * f + 1];
+        int v2 = mesh.faceVertices[3 * f + 2];
+        for (int v : {v0, v1, v2})
+          if (v < 0 || v >= vertices)
+            return false;
+
+        if (v0 == v1 || v1 == v2 || v2 == v0)
+          return true;
+
+        Cartesian3 p0 = mesh.position(v0);
+        Cartesian3 normal =
+            (mesh.position(v1) - p0).cross(mesh.position(v2) - p0);
+        return normal.x == 0.0f && normal.y == 0.0f && normal.z == 0.0f;
+      });
+
+  return defects;
+}
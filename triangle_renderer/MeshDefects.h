@@ -0,0 +1,49 @@
+#ifndef MESH_DEFECTS_H
+#define MESH_DEFECTS_H
+
+#include <vector>
+
+#include "Bitset.h"
+#include "DirectedEdgeMesh.h"
+
+// every element with one kind of defect: a flag per element, how many are
+// flagged and the lowest few ids, so a report stays small however broken the
+// mesh is
+struct DefectList {
+  size_t count = 0;
+  std::vector<int> examples;
+  Bitset flags;
+};
+
+// the defects of a mesh, found without stopping at the first one
+struct MeshDefects {
+  // edges whose vertex or other half is not a valid id
+  DefectList badIndices;
+  // vertices whose first directed edge is out of range, does not leave the
+  // vertex, or is -1 although faces use the vertex
+  DefectList badFirstEdges;
+  // edges without an other half
+  DefectList boundaryEdges;
+  // edges whose other half does not point back or does not run the opposite
+  // way
+  DefectList twinMismatches;
+  // vertices whose faces form more than one fan
+  DefectList pinchVertices;
+  // faces with a repeated vertex or no area
+  DefectList degenerateFaces;
+
+  // true if none of the defects that break a manifold were found, degenerate
+  // faces are reported but do not count
+  bool manifold() const;
+
+  // free the flags once only the counts and examples are needed
+  void dropFlags();
+};
+
+// check every element of the view, which may hold out-of-range indices
+// each kind of defect is one parallel pass over its elements, with chunks
+// aligned to the flag words so that threads never share a word
+// examples are the lowest exampleLimit ids, whatever the thread count
+MeshDefects findDefects(MeshView mesh, int exampleLimit = 10);
+
+#endif
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "MeshFairing.h"
+
+namespace {
+
+// the vertices joined to v by an edge, each once, the two other corners of
+// every face in the fan at v's first directed edge
+void vertexNeighbours(const DirectedEdgeMesh &mesh, int v,
+                      std::vector<int> &neighbours) {
+  neighbours.clear();
+  int first = mesh.firstDirectedEdges[v];
+  if (first == -1)
+    return;
+
+  std::vector<int> fan;
+  mesh.fanEdges(first, fan);
+  for (int e : fan) {
+    neighbours.push_back(mesh.to(e));
+    neighbours.push_back(mesh.from(DirectedEdgeMesh::prev(e)));
+  }
+
+  std::sort(neighbours.begin(), neighbours.end());
+  neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                   neighbours.end());
+}
+
+// compressed rows of a symmetric matrix
+struct SparseMatrix {
+  std::vector<int> rowStart;
+  std::vector<int> columns;
+  std::vector<double> values;
+  std::vector<double> diagonal;
+
+  int rows() const { return (int)rowStart.size() - 1; }
+
+  void multiply(const std::vector<double> &x, std::vector<double> &y) const {
+    for (int r = 0; r < rows(); r++) {
+      double sum = 0.0;
+      for (int i = rowStart[r]; i < rowStart[r + 1]; i++)
+        sum += values[i] * x[columns[i]];
+      y[r] = sum;
+    }
+  }
+};
+
+double dot(const std::vector<double> &a, const std::vector<double> &b) {
+  double sum = 0.0;
+  for (size_t i = 0; i < a.size(); i++)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+// solve A x = b from the x given, with a Jacobi preconditioner
+// returns the iterations taken and sets the relative residual
+int conjugateGradient(const SparseMatrix &A, const std::vector<double> &b,
+                      std::vector<double> &x, double tolerance,
+                      int maxIterations, double &residual) {
+  int n = A.rows();
+  std::vector<double> r(n), z(n), p(n), Ap(n);
+
+  A.multiply(x, Ap);
+  for (int i = 0; i < n; i++) {
+    r[i] = b[i] - Ap[i];
+    z[i] = r[i] / A.diagonal[i];
+  }
+  p = z;
+
+  double bNorm = std::sqrt(dot(b, b));
+  if (bNorm == 0.0)
+    bNorm = 1.0;
+  double rz = dot(r, z);
+
+  int iteration = 0;
+  residual = std::sqrt(dot(r, r)) / bNorm;
+  while (residual > tolerance && iteration < maxIterations) {
+    A.multiply(p, Ap);
+    double pAp = dot(p, Ap);
+    if (pAp <= 0.0)
+      break;
+
+    double alpha = rz / pAp;
+    for (int i = 0; i < n; i++) {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * Ap[i];
+      z[i] = r[i] / A.diagonal[i];
+    }
+
+    double rzNext = dot(r, z);
+    for (int i = 0; i < n; i++)
+      p[i] = z[i] + rzNext / rz * p[i];
+    rz = rzNext;
+
+    iteration++;
+    residual = std::sqrt(dot(r, r)) / bNorm;
+  }
+
+  return iteration;
+}
+
+} // namespace
+
+FairingResult fairVertices(DirectedEdgeMesh &mesh,
+                           const std::vector<int> &freeVertices, int order,
+                           double tolerance, int maxIterations) {
+  FairingResult result;
+
+  // number the free vertices that have faces
+  std::unordered_map<int, int> freeIndex;
+  std::vector<int> unknowns;
+  for (int v : freeVertices) {
+    if (mesh.firstDirectedEdges[v] != -1 && !freeIndex.count(v)) {
+      freeIndex[v] = unknowns.size();
+      unknowns.push_back(v);
+    }
+  }
+
+  int n = unknowns.size();
+  result.vertices = n;
+  if (n == 0)
+    return result;
+
+  // the one-rings needed, found once each
+  std::unordered_map<int, std::vector<int>> rings;
+  auto ring = [&](int v) -> const std::vector<int> & {
+    auto found = rings.find(v);
+    if (found != rings.end())
+      return found->second;
+
+    std::vector<int> &neighbours = rings[v];
+    vertexNeighbours(mesh, v, neighbours);
+    return neighbours;
+  };
+
+  // a row of L as (vertex, weight) pairs
+  auto laplacianRow = [&](int v, std::vector<std::pair<int, double>> &row) {
+    const std::vector<int> &neighbours = ring(v);
+    row.clear();
+    row.push_back({v, (double)neighbours.size()});
+    for (int u : neighbours)
+      row.push_back({u, -1.0});
+  };
+
+  // assemble the rows of L^order at the free vertices, moving the fixed
+  // vertices' terms to the right hand side
+  SparseMatrix A;
+  A.rowStart.push_back(0);
+  A.diagonal.assign(n, 1.0);
+  std::vector<double> rhs[3];
+  for (auto &b : rhs)
+    b.assign(n, 0.0);
+
+  std::vector<std::pair<int, double>> row, inner, entries;
+  for (int i = 0; i < n; i++) {
+    laplacianRow(unknowns[i], row);
+
+    entries.clear();
+    if (order == MEMBRANE_FAIRING) {
+      entries = row;
+    } else {
+      for (auto [k, outerWeight] : row) {
+        laplacianRow(k, inner);
+        for (auto [j, innerWeight] : inner)
+          entries.push_back({j, outerWeight * innerWeight});
+      }
+    }
+
+    std::vector<std::pair<int, double>> matrixRow;
+    for (auto [j, weight] : entries) {
+      auto column = freeIndex.find(j);
+      if (column != freeIndex.end()) {
+        matrixRow.push_back({column->second, weight});
+      } else {
+        Cartesian3 fixed = mesh.position(j);
+        rhs[0][i] -= weight * fixed.x;
+        rhs[1][i] -= weight * fixed.y;
+        rhs[2][i] -= weight * fixed.z;
+      }
+    }
+
+    // merge repeated columns
+    std::sort(matrixRow.begin(), matrixRow.end());
+    for (size_t m = 0; m < matrixRow.size(); m++) {
+      if (m > 0 && matrixRow[m].first == matrixRow[m - 1].first) {
+        A.values.back() += matrixRow[m].second;
+      } else {
+        A.columns.push_back(matrixRow[m].first);
+        A.values.push_back(matrixRow[m].second);
+      }
+    }
+    A.rowStart.push_back(A.columns.size());
+
+    for (int m = A.rowStart[i]; m < A.rowStart[i + 1]; m++)
+      if (A.columns[m] == i && A.values[m] != 0.0)
+        A.diagonal[i] = A.values[m];
+  }
+
+  // solve each coordinate from where the vertices are now
+  std::vector<double> x[3];
+  for (auto &coordinate : x)
+    coordinate.resize(n);
+  for (int i = 0; i < n; i++) {
+    Cartesian3 point = mesh.position(unknowns[i]);
+    x[0][i] = point.x;
+    x[1][i] = point.y;
+    x[2][i] = point.z;
+  }
+
+  for (int c = 0; c < 3; c++) {
+    double residual;
+    int iterations =
+        conjugateGradient(A, rhs[c], x[c], tolerance, maxIterations, residual);
+
+    result.iterations = std::max(result.iterations, iterations);
+    result.residual = std::max(result.residual, residual);
+    result.converged = result.converged && residual <= tolerance;
+  }
+
+  for (int i = 0; i < n; i++)
+    mesh.setPosition(unknowns[i], Cartesian3(x[0][i], x[1][i], x[2][i]));
+
+  return result;
+}
@@ -0,0 +1,40 @@
+#ifndef MESH_FAIRING_H
+#define MESH_FAIRING_H
+
+#include <vector>
+
+#include "DirectedEdgeMesh.h"
+
+// energies a patch can be faired with, as the power of the Laplacian
+const int MEMBRANE_FAIRING = 1;
+const int THIN_PLATE_FAIRING = 2;
+
+// how the solve went, over the three coordinates
+struct FairingResult {
+  // vertices moved, free vertices without faces stay where they are
+  int vertices = 0;
+  // most conjugate gradient iterations taken by a coordinate
+  int iterations = 0;
+  // largest residual norm relative to the right hand side
+  double residual = 0.0;
+  bool converged = true;
+};
+
+// move the free vertices of a mesh to minimise the membrane (order 1) or
+// thin-plate (order 2) energy of the uniform graph Laplacian L = D - A, by
+// solving (L^order x)_v = 0 at every free vertex v with all other vertices
+// fixed
+//
+// the sparse matrix has a row per free vertex and is assembled from the
+// one-rings of the free vertices and, for the thin-plate energy, of their
+// neighbours, so the cost grows with the patches and not with the mesh
+// each coordinate is solved by conjugate gradients with a Jacobi
+// preconditioner, starting from the current positions
+//
+// every group of connected free vertices must touch a fixed vertex, or the
+// system is singular
+FairingResult fairVertices(DirectedEdgeMesh &mesh,
+                           const std::vector<int> &freeVertices, int order,
+                           double tolerance = 1e-6, int maxIterations = 1000);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef MESH_GEOMETRY_H
+#define MESH_GEOMETRY_H
+
+#include <cmath>
+
+#include "Cartesian3.h"
+
+// vector helpers for the mesh repair modules, points are taken by value as
+// the operators of Cartesian3 are not const
+
+inline float dot(const Cartesian3 &a, const Cartesian3 &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// Cartesian3::length is the squared length, so the root is taken here
+inline float vectorLength(const Cartesian3 &v) { return std::sqrt(dot(v, v)); }
+
+inline float distance(Cartesian3 a, Cartesian3 b) { return vectorLength(a - b); }
+
+// unnormalised normal of the triangle a b c, twice its area long
+inline Cartesian3 triangleNormal(Cartesian3 a, Cartesian3 b, Cartesian3 c) {
+  return (b - a).cross(c - a);
+}
+
+#endif
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "DiredgeFile.h"
+#include "MeshParser.h"
+#include "Parallel.h"
+
+MappedFile::MappedFile(const std::string &path) {
+  int fd = path == "-" ? STDIN_FILENO : open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  struct stat info;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+    void *address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address != MAP_FAILED) {
+      data = (const char *)address;
+      length = info.st_size;
+      mapped = opened = true;
+    }
+  }
+
+  // fall back to reading everything, e.g. from a pipe
+  if (!mapped) {
+    char chunk[1 << 16];
+    ssize_t count;
+    while ((count = read(fd, chunk, sizeof(chunk))) > 0)
+      buffer.append(chunk, count);
+
+    opened = count == 0;
+    data = buffer.data();
+    length = buffer.size();
+  }
+
+  if (fd != STDIN_FILENO)
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (mapped)
+    munmap((void *)data, length);
+}
+
+namespace {
+
+bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// from_chars takes no leading '+', which stream extraction did, so one is
+// skipped unless a sign follows it
+const char *skipPlus(const char *at, const char *end) {
+  if (end - at > 1 && at[0] == '+' && at[1] != '-' && at[1] != '+')
+    return at + 1;
+  return at;
+}
+
+} // namespace
+
+TextScanner::TextScanner(const char *begin, const char *end)
+    : start(begin), cursor(begin), finish(end) {}
+
+TextScanner::TextScanner(std::string_view text)
+    : TextScanner(text.data(), text.data() + text.size()) {}
+
+void TextScanner::skipSpace() {
+  while (cursor < finish && isSpace(*cursor))
+    cursor++;
+}
+
+bool TextScanner::atEnd() {
+  skipSpace();
+  return cursor == finish;
+}
+
+bool TextScanner::readToken(std::string_view &token) {
+  skipSpace();
+  const char *tokenStart = cursor;
+  while (cursor < finish && !isSpace(*cursor))
+    cursor++;
+
+  token = std::string_view(tokenStart, cursor - tokenStart);
+  return cursor != tokenStart;
+}
+
+// numbers must be followed by whitespace or the end of the buffer
+bool TextScanner::readInt(int &value) {
+  skipSpace();
+  auto [end, status] =
+      std::from_chars(skipPlus(cursor, finish), finish, value);
+  if (status != std::errc() || (end < finish && !isSpace(*end)))
+    return false;
+
+  cursor = end;
+  return true;
+}
+
+bool TextScanner::readFloat(float &value) {
+  skipSpace();
+  auto [end, status] =
+      std::from_chars(skipPlus(cursor, finish), finish, value);
+  if (status != std::errc() || (end < finish && !isSpace(*end)))
+    return false;
+
+  cursor = end;
+  return true;
+}
+
+bool TextScanner::readLine(std::string_view &line) {
+  if (cursor == finish)
+    return false;
+
+  const char *lineStart = cursor;
+  while (cursor < finish && *cursor != '\n')
+    cursor++;
+
+  line = std::string_view(lineStart, cursor - lineStart);
+  if (cursor < finish)
+    cursor++;
+  return true;
+}
+
+int TextScanner::lineNumber(const char *at) const {
+  int line = 1;
+  for (const char *c = start; c < at; c++)
+    line += *c == '\n';
+  return line;
+}
+
+namespace {
+
+enum RecordType { VERTEX, FIRST_DIRECTED_EDGE, FACE, OTHER_HALF, RECORD_TYPES };
+
+// record type from the first word of a line, -1 if it is not a record
+int recordType(std::string_view word) {
+  if (word == "Vertex")
+    return VERTEX;
+  if (word == "FirstDirectedEdge")
+    return FIRST_DIRECTED_EDGE;
+  if (word == "Face")
+    return FACE;
+  if (word == "OtherHalf")
+    return OTHER_HALF;
+  return -1;
+}
+
+// a parse failure, the earliest line over all chunks is reported
+struct ChunkError {
+  const char *line = nullptr;
+  std::string message;
+};
+
+// parse the lines of one chunk into their slots, marking each slot as seen
+bool parseChunk(const char *begin, const char *end, DirectedEdgeMesh &mesh,
+                std::vector<std::atomic<char>> *seen, ChunkError &error) {
+  TextScanner chunk(begin, end);
+  std::string_view line;
+
+  while (chunk.readLine(line)) {
+    TextScanner fields(line);
+    if (fields.atEnd() || *fields.position() == '#')
+      continue;
+
+    std::string_view word;
+    int id, i1, i2, i3;
+    float x, y, z;
+    int type = fields.readToken(word) ? recordType(word) : -1;
+    bool valid = type != -1 && fields.readInt(id);
+
+    if (valid && type == VERTEX)
+      valid = fields.readFloat(x) && fields.readFloat(y) && fields.readFloat(z);
+    else if (valid && type == FACE)
+      valid = fields.readInt(i1) && fields.readInt(i2) && fields.readInt(i3);
+    else if (valid)
+      valid = fields.readInt(i1);
+
+    if (!valid || !fields.atEnd()) {
+      error.line = line.data();
+      error.message = "invalid line format";
+      return false;
+    }
+
+    if (id < 0 || id >= (int)seen[type].size()) {
+      error.line = line.data();
+      error.message = "id out of range";
+      return false;
+    }
+
+    // a repeated id leaves another id without a record, which is reported
+    // once every chunk is done, so that the message does not depend on
+    // which thread got to the id first
+    if (seen[type][id].exchange(1, std::memory_order_relaxed))
+      continue;
+
+    if (type == VERTEX) {
+      mesh.positions[3 * id] = x;
+      mesh.positions[3 * id + 1] = y;
+      mesh.positions[3 * id + 2] = z;
+    } else if (type == FIRST_DIRECTED_EDGE) {
+      mesh.firstDirectedEdges[id] = i1;
+    } else if (type == FACE) {
+      mesh.faceVertices[3 * id] = i1;
+      mesh.faceVertices[3 * id + 1] = i2;
+      mesh.faceVertices[3 * id + 2] = i3;
+    } else {
+      mesh.otherHalves[id] = i1;
+    }
+  }
+
+  return true;
+}
+
+} // namespace
+
+bool parseMeshRecords(const char *begin, const char *end, DirectedEdgeMesh &mesh,
+                      std::string &error) {
+  // a chunk per megabyte up to one per thread, each starting on a new line
+  size_t bytes = end - begin;
+  int chunks = std::min<size_t>(threadCount(), bytes / (1 << 20) + 1);
+
+  std::vector<const char *> bounds(chunks + 1, end);
+  bounds[0] = begin;
+  for (int c = 1; c < chunks; c++) {
+    const char *bound = std::max(bounds[c - 1], begin + bytes * c / chunks);
+    while (bound < end && bound[-1] != '\n')
+      bound++;
+    bounds[c] = bound;
+  }
+
+  // PASS 1: count the records of each type, only the first word is looked at
+  std::vector<std::array<size_t, RECORD_TYPES>> counts(chunks);
+
+  parallelTasks(chunks, [&](int c) {
+    counts[c].fill(0);
+    TextScanner chunk(bounds[c], bounds[c + 1]);
+    std::string_view line, word;
+
+    while (chunk.readLine(line)) {
+      TextScanner fields(line);
+      if (fields.readToken(word) && recordType(word) != -1)
+        counts[c][recordType(word)]++;
+    }
+  });
+
+  std::array<size_t, RECORD_TYPES> totals{};
+  for (auto &chunkCounts : counts)
+    for (int t = 0; t < RECORD_TYPES; t++)
+      totals[t] += chunkCounts[t];
+
+  mesh.positions.assign(3 * totals[VERTEX], 0.0f);
+  mesh.firstDirectedEdges.assign(totals[FIRST_DIRECTED_EDGE], -1);
+  mesh.faceVertices.assign(3 * totals[FACE], -1);
+  mesh.otherHalves.assign(totals[OTHER_HALF], -1);
+
+  std::vector<std::atomic<char>> seen[RECORD_TYPES];
+  for (int t = 0; t < RECORD_TYPES; t++)
+    seen[t] = std::vector<std::atomic<char>>(totals[t]);
+
+  // PASS 2: parse each line into the slot of its id
+  std::vector<ChunkError> errors(chunks);
+  parallelTasks(chunks, [&](int c) {
+    parseChunk(bounds[c], bounds[c + 1], mesh, seen, errors[c]);
+  });
+
+  // the earliest bad line is the one a serial parse would have stopped at
+  const ChunkError *first = nullptr;
+  for (auto &e : errors)
+    if (e.line != nullptr && (first == nullptr || e.line < first->line))
+      first = &e;
+
+  if (first != nullptr) {
+    error = first->message + " on line " +
+            std::to_string(TextScanner(begin, end).lineNumber(first->line));
+    return false;
+  }
+
+  const char *names[RECORD_TYPES] = {"Vertex", "FirstDirectedEdge", "Face",
+                                     "OtherHalf"};
+  for (int t = 0; t < RECORD_TYPES; t++) {
+    for (size_t id = 0; id < seen[t].size(); id++) {
+      if (!seen[t][id].load(std::memory_order_relaxed)) {
+        error = "no " + std::string(names[t]) + " record with id " +
+                std::to_string(id) + " (ids repeated or skipped)";
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool readMeshRecords(const std::string &path, DirectedEdgeMesh &mesh,
+                     std::string &error) {
+  MappedFile file(path);
+  if (!file.isOpen()) {
+    error = "failed to read file <" + path + ">";
+    return false;
+  }
+
+  bool parsed = isBinaryDiredge(file.begin(), file.end())
+                    ? parseBinaryDiredge(file.begin(), file.end(), mesh, error)
+                    : parseMeshRecords(file.begin(), file.end(), mesh, error);
+
+  return parsed && mesh.checkIndices(error);
+}
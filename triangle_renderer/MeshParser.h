@@ -0,0 +1,93 @@
+#ifndef MESH_PARSER_H
+#define MESH_PARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DirectedEdgeMesh.h"
+
+// read-only view of a whole file
+// regular files are memory mapped, anything else (pipes, or standard input
+// given as "-") is read into memory once
+class MappedFile
+{
+ public:
+  MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool isOpen() const { return opened; }
+  const char *begin() const { return data; }
+  const char *end() const { return data + length; }
+  size_t size() const { return length; }
+
+ private:
+  const char *data = nullptr;
+  size_t length = 0;
+  bool opened = false;
+  bool mapped = false;
+
+  // holds the contents when the file could not be mapped
+  std::string buffer;
+};
+
+// tokeniser over a text buffer
+// numbers are converted with std::from_chars, so there is no locale lookup
+// and nothing is allocated
+class TextScanner
+{
+ public:
+  TextScanner(const char *begin, const char *end);
+  TextScanner(std::string_view text);
+
+  // skip spaces, tabs and line breaks
+  void skipSpace();
+
+  // true once only whitespace is left
+  bool atEnd();
+
+  // each reader skips leading whitespace and fails without moving on a bad
+  // or missing value
+  bool readToken(std::string_view &token);
+  bool readInt(int &value);
+  bool readFloat(float &value);
+
+  // the rest of the current line, moving past its line break
+  bool readLine(std::string_view &line);
+
+  const char *position() const { return cursor; }
+
+  // 1-based line of a position in the buffer, counted on demand for messages
+  int lineNumber(const char *at) const;
+
+ private:
+  const char *start;
+  const char *cursor;
+  const char *finish;
+};
+
+// parse the Vertex, FirstDirectedEdge, Face and OtherHalf records of a .face
+// or .diredge text buffer into the arrays of a mesh, each record stored at the
+// id given on its line, skipping comments and blank lines
+//
+// large buffers are split at line breaks into one chunk per thread: a first
+// pass counts the records of each type to size the arrays, a second parses
+// every line into the slot of its id, so the result does not depend on the
+// number of threads
+//
+// ids must run from 0 to one less than the number of records of their type
+// returns false and describes the first bad line in error on failure
+// arrays with no records (e.g. the other halves of a .face) are left empty
+bool parseMeshRecords(const char *begin, const char *end, DirectedEdgeMesh &mesh,
+                      std::string &error);
+
+// map the file and parse it as above, binary .diredge files (see
+// DiredgeFile.h) are recognised by their magic and copied in instead
+// the indices read are checked with DirectedEdgeMesh::checkIndices
+bool readMeshRecords(const std::string &path, DirectedEdgeMesh &mesh,
+                     std::string &error);
+
+#endif
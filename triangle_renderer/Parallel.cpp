@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Parallel.h"
+
+namespace {
+
+thread_local bool serialThread = false;
+
+// threads to use outside a SerialScope
+int configuredThreads() {
+  static int count = [] {
+    const char *setting = std::getenv("MESH_THREADS");
+    if (setting != nullptr && std::atoi(setting) > 0)
+      return std::atoi(setting);
+
+    int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+  }();
+
+  return count;
+}
+
+// one call's tasks, claimed by index by whichever thread is free
+struct Batch {
+  const std::function<void(int)> *task;
+  int count;
+  std::atomic<int> next{0};
+  int unfinished;
+  std::mutex mutex;
+  std::condition_variable finished;
+
+  // claim and run the next task, false once every task has been claimed
+  bool runNext() {
+    int t = next++;
+    if (t >= count)
+      return false;
+
+    (*task)(t);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--unfinished == 0)
+      finished.notify_all();
+    return true;
+  }
+};
+
+// worker threads started on first use and kept until exit, so that each
+// parallel call only queues its tasks rather than starting threads
+//
+// the calling thread runs the tasks of its own call too, and only waits for
+// tasks other threads have already started, so a task may itself make
+// parallel calls, which is how meshRepair and manifoldTest nest them
+class ThreadPool
+{
+ public:
+  ThreadPool(int workers) {
+    for (int w = 0; w < workers; w++)
+      threads.emplace_back([this] { work(); });
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  void run(int count, const std::function<void(int)> &task) {
+    auto batch = std::make_shared<Batch>();
+    batch->task = &task;
+    batch->count = count;
+    batch->unfinished = count;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      batches.push_back(batch);
+    }
+    if (count > 2)
+      wake.notify_all();
+    else
+      wake.notify_one();
+
+    while (batch->runNext())
+      ;
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&] { return batch->unfinished == 0; });
+  }
+
+ private:
+  std::vector<std::thread> threads;
+  std::deque<std::shared_ptr<Batch>> batches;
+  bool stopping = false;
+  std::mutex mutex;
+  std::condition_variable wake;
+
+  void work() {
+    for (;;) {
+      std::shared_ptr<Batch> batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&] { return stopping || !batches.empty(); });
+        if (stopping)
+          return;
+        batch = batches.front();
+      }
+
+      // a batch leaves the queue once all of its tasks are claimed
+      if (!batch->runNext()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!batches.empty() && batches.front() == batch)
+          batches.pop_front();
+      }
+    }
+  }
+};
+
+ThreadPool &threadPool() {
+  static ThreadPool pool(configuredThreads() - 1);
+  return pool;
+}
+
+} // namespace
+
+SerialScope::SerialScope() : wasSerial(serialThread) { serialThread = true; }
+
+SerialScope::~SerialScope() { serialThread = wasSerial; }
+
+int threadCount() {
+  return serialThread ? 1 : configuredThreads();
+}
+
+int parallelChunks(size_t count) {
+  // small inputs are not worth handing to other threads
+  size_t chunks = count / 4096 + 1;
+  if (chunks > (size_t)threadCount())
+    chunks = threadCount();
+  return chunks;
+}
+
+void parallelFor(size_t count,
+                 const std::function<void(size_t, size_t, int)> &body) {
+  int chunks = parallelChunks(count);
+  if (chunks == 1) {
+    body(0, count, 0);
+    return;
+  }
+
+  parallelTasks(chunks, [&](int c) {
+    body(count * c / chunks, count * (c + 1) / chunks, c);
+  });
+}
+
+void parallelTasks(int count, const std::function<void(int)> &task) {
+  if (count == 1)
+    task(0);
+  else if (count > 1)
+    threadPool().run(count, task);
+}
+
+void parallelQueue(size_t count, int workers,
+                   const std::function<void(size_t)> &item) {
+  std::atomic<size_t> next(0);
+
+  parallelTasks(std::min<size_t>(workers, count), [&](int) {
+    for (size_t i = next++; i < count; i = next++)
+      item(i);
+  });
+}
+
+void parallelRadixSort(std::vector<KeyIndex> &records) {
+  size_t n = records.size();
+  if (n < 2)
+    return;
+
+  std::vector<KeyIndex> buffer(n);
+  int chunks = parallelChunks(n);
+  std::vector<std::array<size_t, 256>> offsets(chunks);
+
+  for (int shift = 0; shift < 64; shift += 8) {
+    // histogram of this digit for each chunk
+    parallelFor(n, [&](size_t begin, size_t end, int chunk) {
+      offsets[chunk].fill(0);
+      for (size_t i = begin; i < end; i++)
+        offsets[chunk][(records[i].key >> shift) & 0xff]++;
+    });
+
+    // skip the pass if every key has the same digit
+    bool sorted = false;
+    for (int d = 0; d < 256 && !sorted; d++) {
+      size_t total = 0;
+      for (int c = 0; c < chunks; c++)
+        total += offsets[c][d];
+      sorted = total == n;
+    }
+    if (sorted)
+      continue;
+
+    // digit-major prefix sum, so earlier chunks land first within a digit
+    size_t sum = 0;
+    for (int d = 0; d < 256; d++) {
+      for (int c = 0; c < chunks; c++) {
+        size_t count = offsets[c][d];
+        offsets[c][d] = sum;
+        sum += count;
+      }
+    }
+
+    parallelFor(n, [&](size_t begin, size_t end, int chunk) {
+      for (size_t i = begin; i < end; i++)
+        buffer[offsets[chunk][(records[i].key >> shift) & 0xff]++] = records[i];
+    });
+
+    records.swap(buffer);
+  }
+}
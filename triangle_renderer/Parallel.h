@@ -0,0 +1,54 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// number of worker threads to use, the MESH_THREADS environment variable
+// overrides the hardware concurrency
+// 1 on a thread inside a SerialScope
+int threadCount();
+
+// while alive, keeps the parallel helpers below on the calling thread, for
+// work that is already spread over threads at a coarser level
+class SerialScope
+{
+ public:
+  SerialScope();
+  ~SerialScope();
+
+ private:
+  bool wasSerial;
+};
+
+// number of chunks parallelFor splits count items into
+int parallelChunks(size_t count);
+
+// split [0, count) into parallelChunks(count) contiguous chunks and run body on
+// each one as a parallelTasks task, body gets (begin, end, chunk index)
+void parallelFor(size_t count,
+                 const std::function<void(size_t, size_t, int)> &body);
+
+// run task(0) .. task(count - 1) on a pool of threadCount() - 1 threads kept
+// for the whole run, with the calling thread, and wait for them
+// tasks may make parallel calls of their own
+void parallelTasks(int count, const std::function<void(int)> &task);
+
+// run item(0) .. item(count - 1) on up to workers threads, each thread takes
+// the next item not yet started as soon as it is free, so items of uneven cost
+// balance out and are started in index order
+void parallelQueue(size_t count, int workers,
+                   const std::function<void(size_t)> &item);
+
+// a sort record, index is carried along with its key
+struct KeyIndex {
+  uint64_t key;
+  int32_t index;
+};
+
+// stable LSD radix sort on the key, so equal keys keep their input order
+// each 8 bit pass builds per-thread histograms and scatters in parallel
+void parallelRadixSort(std::vector<KeyIndex> &records);
+
+#endif
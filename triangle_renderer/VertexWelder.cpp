@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Hashing.h"
+#include "Parallel.h"
+#include "VertexWelder.h"
+
+namespace {
+
+uint64_t pointHash(const Cartesian3 &p) {
+  uint64_t h = mixBits(((uint64_t)floatBits(p.x) << 32) | floatBits(p.y));
+  return mixBits(h ^ floatBits(p.z));
+}
+
+bool sameBits(const Cartesian3 &a, const Cartesian3 &b) {
+  return floatBits(a.x) == floatBits(b.x) && floatBits(a.y) == floatBits(b.y) &&
+         floatBits(a.z) == floatBits(b.z);
+}
+
+float distanceSquared(const Cartesian3 &a, const Cartesian3 &b) {
+  float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+  return dx * dx + dy * dy + dz * dz;
+}
+
+// grid coordinate along one axis, clamped so that neighbours stay in range
+int32_t cellCoordinate(float value, float tolerance) {
+  double c = std::floor((double)value / tolerance);
+  if (!(c > -1e9))
+    return -1000000000;
+  if (c > 1e9)
+    return 1000000000;
+  return (int32_t)c;
+}
+
+} // namespace
+
+VertexWelder::VertexWelder(size_t expectedPoints, float weldTolerance)
+    : tolerance(weldTolerance), slots(tableSizeFor(expectedPoints), -1) {
+  points.reserve(expectedPoints);
+
+  if (tolerance > 0.0f)
+    cells.resize(slots.size());
+}
+
+int VertexWelder::weld(const Cartesian3 &point) {
+  if (tolerance > 0.0f)
+    return weldTolerant(point);
+  return weldExact(point);
+}
+
+int VertexWelder::weldExact(const Cartesian3 &point) {
+  size_t slot = slotFor(point);
+  if (slots[slot] != -1)
+    return slots[slot];
+
+  int id = points.size();
+  points.push_back(point);
+  slots[slot] = id;
+
+  if (points.size() * 2 > slots.size())
+    grow();
+
+  return id;
+}
+
+int VertexWelder::weldTolerant(const Cartesian3 &point) {
+  Cell home = cellOf(point);
+
+  // nearest point within the tolerance, the lowest id wins a tie
+  int best = -1;
+  float bestDistance = tolerance * tolerance;
+
+  for (int dx = -1; dx <= 1; dx++) {
+    for (int dy = -1; dy <= 1; dy++) {
+      for (int dz = -1; dz <= 1; dz++) {
+        size_t slot = slotFor(Cell{home.x + dx, home.y + dy, home.z + dz});
+
+        for (int id = slots[slot]; id != -1; id = nextInCell[id]) {
+          float d = distanceSquared(points[id], point);
+          if (d < bestDistance || (d == bestDistance && (best == -1 || id < best))) {
+            best = id;
+            bestDistance = d;
+          }
+        }
+      }
+    }
+  }
+
+  if (best != -1)
+    return best;
+
+  int id = points.size();
+  points.push_back(point);
+
+  size_t slot = slotFor(home);
+  if (slots[slot] == -1) {
+    cells[slot] = home;
+    cellCount++;
+  }
+  nextInCell.push_back(slots[slot]);
+  slots[slot] = id;
+
+  if (cellCount * 2 > slots.size())
+    grow();
+
+  return id;
+}
+
+// linear probing: walk from the home slot until we find the point or a gap
+size_t VertexWelder::slotFor(const Cartesian3 &point) const {
+  size_t mask = slots.size() - 1;
+  size_t slot = pointHash(point) & mask;
+
+  while (slots[slot] != -1 && !sameBits(points[slots[slot]], point))
+    slot = (slot + 1) & mask;
+
+  return slot;
+}
+
+size_t VertexWelder::slotFor(const Cell &cell) const {
+  size_t mask = slots.size() - 1;
+  uint64_t h = mixBits(((uint64_t)(uint32_t)cell.x << 32) | (uint32_t)cell.y);
+  size_t slot = mixBits(h ^ (uint32_t)cell.z) & mask;
+
+  while (slots[slot] != -1 &&
+         (cells[slot].x != cell.x || cells[slot].y != cell.y ||
+          cells[slot].z != cell.z))
+    slot = (slot + 1) & mask;
+
+  return slot;
+}
+
+VertexWelder::Cell VertexWelder::cellOf(const Cartesian3 &point) const {
+  return Cell{cellCoordinate(point.x, tolerance),
+              cellCoordinate(point.y, tolerance),
+              cellCoordinate(point.z, tolerance)};
+}
+
+void VertexWelder::grow() {
+  if (tolerance <= 0.0f) {
+    slots.assign(slots.size() * 2, -1);
+
+    // points are unique, so re-inserting only needs to find an empty slot
+    for (size_t id = 0; id < points.size(); id++)
+      slots[slotFor(points[id])] = id;
+    return;
+  }
+
+  std::vector<int> oldSlots(slots.size() * 2, -1);
+  std::vector<Cell> oldCells(cells.size() * 2);
+  oldSlots.swap(slots);
+  oldCells.swap(cells);
+
+  // chains move over whole, only the cell slots need re-hashing
+  for (size_t i = 0; i < oldSlots.size(); i++) {
+    if (oldSlots[i] == -1)
+      continue;
+
+    size_t slot = slotFor(oldCells[i]);
+    cells[slot] = oldCells[i];
+    slots[slot] = oldSlots[i];
+  }
+}
+
+void weldSorted(const std::vector<Cartesian3> &corners,
+                std::vector<Cartesian3> &points, std::vector<int> &cornerIDs) {
+  size_t n = corners.size();
+  points.clear();
+  cornerIDs.assign(n, -1);
+  if (n == 0)
+    return;
+
+  // bounding box, reduced per chunk first
+  int chunks = parallelChunks(n);
+  std::vector<Cartesian3> chunkMin(chunks, corners[0]);
+  std::vector<Cartesian3> chunkMax(chunks, corners[0]);
+
+  parallelFor(n, [&](size_t begin, size_t end, int chunk) {
+    Cartesian3 &lo = chunkMin[chunk], &hi = chunkMax[chunk];
+    for (size_t i = begin; i < end; i++) {
+      lo.x = std::min(lo.x, corners[i].x);
+      lo.y = std::min(lo.y, corners[i].y);
+      lo.z = std::min(lo.z, corners[i].z);
+      hi.x = std::max(hi.x, corners[i].x);
+      hi.y = std::max(hi.y, corners[i].y);
+      hi.z = std::max(hi.z, corners[i].z);
+    }
+  });
+
+  Cartesian3 lo = chunkMin[0], hi = chunkMax[0];
+  for (int c = 1; c < chunks; c++) {
+    lo = Cartesian3(std::min(lo.x, chunkMin[c].x), std::min(lo.y, chunkMin[c].y),
+                    std::min(lo.z, chunkMin[c].z));
+    hi = Cartesian3(std::max(hi.x, chunkMax[c].x), std::max(hi.y, chunkMax[c].y),
+                    std::max(hi.z, chunkMax[c].z));
+  }
+
+  // 21 bits per axis, equal points always get equal keys while distinct
+  // points may share one and are told apart when the runs are collapsed
+  const double cells = (1 << 21) - 1;
+  auto quantise = [cells](float value, float low, float high) -> uint64_t {
+    double t = high > low ? (value - (double)low) / ((double)high - low) : 0.0;
+    if (!(t > 0.0))
+      return 0;
+    return t >= 1.0 ? (uint64_t)cells : (uint64_t)(t * cells);
+  };
+
+  std::vector<KeyIndex> records(n);
+  parallelFor(n, [&](size_t begin, size_t end, int) {
+    for (size_t i = begin; i < end; i++) {
+      const Cartesian3 &p = corners[i];
+      records[i].key = quantise(p.x, lo.x, hi.x) << 42 |
+                       quantise(p.y, lo.y, hi.y) << 21 |
+                       quantise(p.z, lo.z, hi.z);
+      records[i].index = i;
+    }
+  });
+
+  parallelRadixSort(records);
+
+  // the corner each corner welds onto (the first equal one), written per run
+  // runs that straddle a chunk boundary belong to the chunk they start in
+  std::vector<int> &firstCorner = cornerIDs;
+
+  parallelFor(n, [&](size_t begin, size_t end, int) {
+    while (begin > 0 && begin < n && records[begin].key == records[begin - 1].key)
+      begin++;
+    while (end < n && end > 0 && records[end].key == records[end - 1].key)
+      end++;
+
+    std::vector<int> run;
+    for (size_t i = begin; i < end;) {
+      size_t j = i + 1;
+      while (j < n && records[j].key == records[i].key)
+        j++;
+
+      if (j - i == 1) {
+        firstCorner[records[i].index] = records[i].index;
+      } else {
+        // order the run by exact bit pattern, then by corner
+        run.clear();
+        for (size_t k = i; k < j; k++)
+          run.push_back(records[k].index);
+
+        std::sort(run.begin(), run.end(), [&](int a, int b) {
+          const Cartesian3 &p = corners[a], &q = corners[b];
+          if (floatBits(p.x) != floatBits(q.x))
+            return floatBits(p.x) < floatBits(q.x);
+          if (floatBits(p.y) != floatBits(q.y))
+            return floatBits(p.y) < floatBits(q.y);
+          if (floatBits(p.z) != floatBits(q.z))
+            return floatBits(p.z) < floatBits(q.z);
+          return a < b;
+        });
+
+        int first = run[0];
+        for (size_t k = 0; k < run.size(); k++) {
+          if (!sameBits(corners[run[k]], corners[first]))
+            first = run[k];
+          firstCorner[run[k]] = first;
+        }
+      }
+
+      i = j;
+    }
+  });
+
+  // ids go to first corners in corner order, a prefix sum over the chunks
+  std::vector<int> idStart(chunks + 1, 0);
+  parallelFor(n, [&](size_t begin, size_t end, int chunk) {
+    int count = 0;
+    for (size_t i = begin; i < end; i++)
+      count += firstCorner[i] == (int)i;
+    idStart[chunk + 1] = count;
+  });
+  for (int c = 0; c < chunks; c++)
+    idStart[c + 1] += idStart[c];
+
+  points.resize(idStart[chunks]);
+
+  std::vector<int> firstID(n);
+  parallelFor(n, [&](size_t begin, size_t end, int chunk) {
+    int id = idStart[chunk];
+    for (size_t i = begin; i < end; i++) {
+      if (firstCorner[i] == (int)i) {
+        points[id] = corners[i];
+        firstID[i] = id++;
+      }
+    }
+  });
+
+  parallelFor(n, [&](size_t begin, size_t end, int) {
+    for (size_t i = begin; i < end; i++)
+      cornerIDs[i] = firstID[firstCorner[i]];
+  });
+}
@@ -0,0 +1,65 @@
+#ifndef VERTEX_WELDER_H
+#define VERTEX_WELDER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Cartesian3.h"
+
+// assigns an id to each distinct point in the order they are first seen
+//
+// with no tolerance the lookup is an open addressing hash table keyed on the
+// bit pattern of the three coordinates, so welding n points takes expected
+// O(n) time
+//
+// with a tolerance, points closer than it are merged onto the earlier point
+// the candidates are found through a uniform hash grid with cells as wide as
+// the tolerance, so only the 27 cells around the point need to be checked
+class VertexWelder
+{
+ public:
+  // the distinct points, indexed by their id
+  std::vector<Cartesian3> points;
+
+  // expectedPoints is only a hint for sizing the table
+  VertexWelder(size_t expectedPoints = 0, float weldTolerance = 0.0f);
+
+  // return the id of the point, adding it if it has not been seen before
+  int weld(const Cartesian3 &point);
+
+ private:
+  struct Cell {
+    int32_t x, y, z;
+  };
+
+  float tolerance;
+
+  // vertex id stored in each slot, -1 when the slot is empty
+  // in tolerance mode this is the first vertex of the cell's chain instead
+  std::vector<int> slots;
+
+  // tolerance mode only: the cell stored in each slot and the next vertex in
+  // the same cell for each vertex
+  std::vector<Cell> cells;
+  std::vector<int> nextInCell;
+  size_t cellCount = 0;
+
+  int weldExact(const Cartesian3 &point);
+  int weldTolerant(const Cartesian3 &point);
+
+  size_t slotFor(const Cartesian3 &point) const;
+  size_t slotFor(const Cell &cell) const;
+  Cell cellOf(const Cartesian3 &point) const;
+  void grow();
+};
+
+// exact welding of a whole triangle soup at once, for large inputs
+// each corner is quantised to a 64 bit key, the (key, corner) pairs are radix
+// sorted in parallel and each run of equal keys is split into groups of equal
+// points, the group's first corner decides the id
+// the points and cornerIDs written are identical to welding the corners one at
+// a time with VertexWelder::weld
+void weldSorted(const std::vector<Cartesian3> &corners,
+                std::vector<Cartesian3> &points, std::vector<int> &cornerIDs);
+
+#endif
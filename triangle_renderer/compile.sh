@@ -1,3 +1,2 @@
-qmake -project "QT += core gui widgets opengl openglwidgets" "LIBS += -lGL -lGLU"
 qmake
 make
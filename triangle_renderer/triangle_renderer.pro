@@ -20,18 +20,20 @@ HEADERS += Ball.h \
            BallAux.h \
            BallMath.h \
            Cartesian3.h \
-           DirectedEdge.h \
-           Face.h \
+           DirectedEdgeMesh.h \
+           DiredgeFile.h \
            GeometricSurfaceFaceDS.h \
            GeometricWidget.h \
-           Vertex.h
+           MeshParser.h \
+           Parallel.h
 SOURCES += Ball.cpp \
            BallAux.cpp \
            BallMath.cpp \
            Cartesian3.cpp \
-           DirectedEdge.cpp \
-           Face.cpp \
+           DirectedEdgeMesh.cpp \
+           DiredgeFile.cpp \
            GeometricSurfaceFaceDS.cpp \
            GeometricWidget.cpp \
            main.cpp \
-           Vertex.cpp
+           MeshParser.cpp \
+           Parallel.cpp